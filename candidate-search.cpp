@@ -0,0 +1,99 @@
+#include "candidate-search.h"
+#include "trace-events.h"
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+void CandidateSearch::start(WorkerPool &pool, const CandidateSearchParams &params)
+{
+    cancel();
+    state = make_shared<State>();
+    state->params = params;
+    state->remaining = params.candidates;
+    state->results.reserve(params.candidates);
+    state->started = state->lastDone = chrono::steady_clock::now();
+    for (int i = 0; i < params.candidates; ++i)
+    {
+        shared_ptr<State> s = state;
+        pool.submit([s, i]
+                    { buildCandidate(*s, i); });
+    }
+}
+
+void CandidateSearch::cancel()
+{
+    if (state)
+        state->cancelled = true;
+    state.reset();
+}
+
+void CandidateSearch::buildCandidate(State &s, int id)
+{
+    MAZE_TRACE_SCOPE_DETAIL("candidate", nullptr, id);
+    // once one candidate is in the band the rest are skipped
+    if (!s.found.load() && !s.cancelled.load())
+    {
+        const CandidateSearchParams &p = s.params;
+        unsigned long long seed = deriveSeed(p.baseSeed, static_cast<unsigned long long>(id));
+        MazeGrid grid;
+        TargetReport rep;
+        MazeMetrics shape;
+        if (p.targeted)
+            generateForDifficulty(grid, p.rows, p.cols, seed, p.minScore, p.maxScore, &rep);
+        else
+            generateMaze(grid, p.rows, p.cols, seed, p.algorithm, &shape);
+        MazeDifficulty md(id, p.targeted ? rep.score : difficultyScore(p.rows, p.cols, shape), p.rows, p.cols);
+        md.seed = seed;
+        md.attempts = p.targeted ? rep.attempts : 1;
+        md.cellBytes = grid.bytes();
+        if (md.score >= p.minScore && md.score <= p.maxScore)
+            s.found = true;
+        lock_guard<mutex> g(s.lock);
+        s.results.push_back(std::move(md));
+        s.lastDone = chrono::steady_clock::now();
+    }
+    s.remaining--;
+}
+
+static float distanceToBand(float score, float minS, float maxS)
+{
+    if (score < minS)
+        return minS - score;
+    if (score > maxS)
+        return score - maxS;
+    return 0.0f;
+}
+
+bool CandidateSearch::take(MazeDifficulty &picked, vector<MazeDifficulty> *all, CandidateSearchReport *report)
+{
+    if (!ready())
+        return false;
+    State &s = *state;
+    if (report)
+    {
+        report->built = static_cast<int>(s.results.size());
+        report->attempts = 0;
+        for (const MazeDifficulty &md : s.results)
+            report->attempts += md.attempts;
+        report->ms = chrono::duration<double, milli>(s.lastDone - s.started).count();
+    }
+    sort(s.results.begin(), s.results.end(), [](const MazeDifficulty &a, const MazeDifficulty &b)
+         { return a.score != b.score ? a.score > b.score : a.id < b.id; });
+    int best = -1;
+    float bestDist = 0;
+    for (int i = 0; i < static_cast<int>(s.results.size()); ++i)
+    {
+        float d = distanceToBand(s.results[i].score, s.params.minScore, s.params.maxScore);
+        if (best < 0 || d < bestDist)
+        {
+            best = i;
+            bestDist = d;
+        }
+    }
+    if (best >= 0)
+        picked = s.results[best];
+    if (all)
+        *all = std::move(s.results);
+    state.reset();
+    return best >= 0;
+}
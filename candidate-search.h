@@ -0,0 +1,63 @@
+// Concurrent "generate N mazes and keep the one that fits the difficulty"
+// search. Every candidate is built on a worker thread with its own grid and
+// seed; the caller polls ready() and never blocks on the workers. Targeted
+// candidates steer toward the band themselves (generateForDifficulty), so
+// one candidate is normally enough; untargeted ones are plain
+// generateMaze calls kept only if they happen to land in the band.
+#pragma once
+
+#include "maze-core.h"
+#include "worker-pool.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct CandidateSearchParams
+{
+    int rows = 20, cols = 20;
+    int candidates = 6;
+    float minScore = 0, maxScore = 100;
+    unsigned long long baseSeed = 0; // candidate i uses deriveSeed(baseSeed, i)
+    MazeAlgorithm algorithm = ALGO_BACKTRACKER; // untargeted only
+    bool targeted = true;
+};
+
+struct CandidateSearchReport
+{
+    int built = 0;    // candidates generated (the rest were skipped)
+    int attempts = 0; // mazes generated across all candidates
+    double ms = 0;    // start() until the last candidate finished
+};
+
+class CandidateSearch
+{
+    // shared with the queued tasks so a cancelled search can finish safely
+    struct State
+    {
+        CandidateSearchParams params;
+        std::atomic<bool> found{false};
+        std::atomic<bool> cancelled{false};
+        std::atomic<int> remaining{0};
+        std::mutex lock;
+        std::vector<MazeDifficulty> results;
+        std::chrono::steady_clock::time_point started, lastDone;
+    };
+    std::shared_ptr<State> state;
+
+    static void buildCandidate(State &s, int id);
+
+public:
+    ~CandidateSearch() { cancel(); }
+
+    void start(WorkerPool &pool, const CandidateSearchParams &params);
+    void cancel();
+    bool active() const { return state != nullptr; }
+    bool ready() const { return state && state->remaining.load() == 0; }
+
+    // Once ready(): moves the chosen candidate into picked (highest score inside
+    // the band, otherwise the one closest to it) and ends the search. All built
+    // candidates, best first, are returned through all when it is not null.
+    bool take(MazeDifficulty &picked, std::vector<MazeDifficulty> *all = nullptr, CandidateSearchReport *report = nullptr);
+};
@@ -0,0 +1,88 @@
+#include "chunked-maze.h"
+#include <algorithm>
+using namespace std;
+
+static int floorDiv(int a, int b)
+{
+    int q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+void ChunkedMaze::reset(unsigned long long seed)
+{
+    worldSeed = seed;
+    lru.clear();
+    index.clear();
+    generated = evicted = 0;
+}
+
+// Border doors: side 0 is the east edge of chunk (cx, cy), side 1 its south
+// edge. Both chunks sharing an edge ask for the same (cx, cy, side), so they
+// always agree on where the opening is. Door seeds are derived twice, first
+// under their own domain tag, so no door stream can coincide with a chunk's
+// generation stream (key * 2).
+static const unsigned long long DOOR_DOMAIN = 0x646F6F7273ULL; // "doors"
+
+int ChunkedMaze::doorOffset(int cx, int cy, int side) const
+{
+    unsigned long long h = deriveSeed(deriveSeed(worldSeed, static_cast<unsigned long long>(key(cx, cy)) ^ DOOR_DOMAIN), side);
+    return static_cast<int>(h % static_cast<unsigned long long>(chunkSize));
+}
+
+void ChunkedMaze::buildChunk(MazeChunk &c) const
+{
+    generateFullMaze(c.grid, chunkSize, chunkSize, deriveSeed(worldSeed, static_cast<unsigned long long>(key(c.cx, c.cy)) * 2));
+
+    // every chunk is a perfect maze and every pair of neighbours shares a
+    // door, so the whole world stays connected
+    int last = chunkSize - 1;
+    c.grid.clearWall(c.grid.index(last, doorOffset(c.cx, c.cy, 0)), DIR_RIGHT);
+    c.grid.clearWall(c.grid.index(0, doorOffset(c.cx - 1, c.cy, 0)), DIR_LEFT);
+    c.grid.clearWall(c.grid.index(doorOffset(c.cx, c.cy, 1), last), DIR_DOWN);
+    c.grid.clearWall(c.grid.index(doorOffset(c.cx, c.cy - 1, 1), 0), DIR_UP);
+}
+
+const MazeChunk &ChunkedMaze::chunk(int cx, int cy)
+{
+    long long k = key(cx, cy);
+    auto it = index.find(k);
+    if (it != index.end())
+    {
+        lru.splice(lru.begin(), lru, it->second);
+        return lru.front();
+    }
+    if (static_cast<int>(lru.size()) >= capacity && !lru.empty())
+    {
+        // recycle the least recently used chunk (and its grid buffer)
+        index.erase(key(lru.back().cx, lru.back().cy));
+        lru.splice(lru.begin(), lru, prev(lru.end()));
+        evicted++;
+    }
+    else
+        lru.emplace_front();
+    MazeChunk &c = lru.front();
+    c.cx = cx;
+    c.cy = cy;
+    buildChunk(c);
+    index[k] = lru.begin();
+    generated++;
+    return c;
+}
+
+unsigned char ChunkedMaze::wallMask(int x, int y)
+{
+    int cx = floorDiv(x, chunkSize), cy = floorDiv(y, chunkSize);
+    const MazeChunk &c = chunk(cx, cy);
+    return c.grid.wallMask(c.grid.index(x - cx * chunkSize, y - cy * chunkSize));
+}
+
+void ChunkedMaze::ensureWindow(int x, int y, int radius)
+{
+    int cx0 = floorDiv(x - radius, chunkSize), cx1 = floorDiv(x + radius, chunkSize);
+    int cy0 = floorDiv(y - radius, chunkSize), cy1 = floorDiv(y + radius, chunkSize);
+    capacity = max(capacity, (cx1 - cx0 + 1) * (cy1 - cy0 + 1));
+    for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx)
+            chunk(cx, cy);
+    chunk(floorDiv(x, chunkSize), floorDiv(y, chunkSize));
+}
@@ -0,0 +1,56 @@
+// Endless maze made of fixed-size chunks that are generated on demand from a
+// world seed and kept in a bounded LRU cache. A chunk depends only on the
+// world seed and its chunk coordinates, so an evicted chunk comes back
+// identical when the player returns to it.
+#pragma once
+
+#include "maze-core.h"
+#include <list>
+#include <unordered_map>
+
+struct MazeChunk
+{
+    int cx = 0, cy = 0;
+    MazeGrid grid; // chunkSize x chunkSize cells in chunk-local coordinates
+};
+
+class ChunkedMaze
+{
+    unsigned long long worldSeed = 0;
+    int chunkSize = 16;
+    int capacity = 64;
+    std::list<MazeChunk> lru; // most recently used first
+    std::unordered_map<long long, std::list<MazeChunk>::iterator> index;
+    long long generated = 0, evicted = 0;
+
+    // shifted as unsigned: shifting a negative signed cx is undefined
+    static long long key(int cx, int cy)
+    {
+        return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned>(cx)) << 32) | static_cast<unsigned>(cy));
+    }
+    int doorOffset(int cx, int cy, int side) const;
+    void buildChunk(MazeChunk &c) const;
+    const MazeChunk &chunk(int cx, int cy);
+
+public:
+    explicit ChunkedMaze(int chunkCells = 16, int maxChunks = 64) : chunkSize(chunkCells), capacity(maxChunks) {}
+
+    // drops every cached chunk and starts a new world
+    void reset(unsigned long long seed);
+    unsigned long long seed() const { return worldSeed; }
+    int getChunkSize() const { return chunkSize; }
+
+    // world cell queries; (x, y) may be negative, the world has no edge
+    unsigned char wallMask(int x, int y);
+    bool hasWall(int x, int y, int d) { return (wallMask(x, y) >> d) & 1; }
+
+    // Loads every chunk touching the square of radius cells around (x, y)
+    // and marks them most recently used, so eviction only hits chunks
+    // outside the window. Capacity grows to fit the window if needed.
+    void ensureWindow(int x, int y, int radius);
+
+    int residentChunks() const { return static_cast<int>(lru.size()); }
+    int maxChunks() const { return capacity; }
+    long long chunksGenerated() const { return generated; }
+    long long chunksEvicted() const { return evicted; }
+};
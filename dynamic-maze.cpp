@@ -0,0 +1,403 @@
+#include "dynamic-maze.h"
+#include <algorithm>
+#include <cstdlib>
+using namespace std;
+
+// ---------- Shifting walls ---------- //
+// which side of cell faces the adjacent cell next (cols >= 2)
+static int sideToward(int cols, int cell, int next)
+{
+    int diff = next - cell;
+    if (diff == -cols)
+        return DIR_UP;
+    if (diff == cols)
+        return DIR_DOWN;
+    return diff < 0 ? DIR_LEFT : DIR_RIGHT;
+}
+
+// Passages already on some trap's loop, one bit per interior wall: the
+// RIGHT or DOWN side of the upper-left cell of the pair.
+static unsigned char &ownerByte(vector<unsigned char> &owned, int cols, int cell, int &bit, int side)
+{
+    if (side == DIR_LEFT || side == DIR_UP)
+    {
+        cell += DIR_DY[side] * cols + DIR_DX[side];
+        side = OppositeDir(side);
+    }
+    bit = 1 << side;
+    return owned[cell];
+}
+
+void ShiftingWalls::place(const MazeGrid &grid, unsigned long long seed, int count)
+{
+    walls.clear();
+    int rows = grid.getRows(), cols = grid.getCols();
+    if (count <= 0 || rows < 2 || cols < 2)
+        return;
+    MazeRng rng(seed);
+    vector<unsigned char> owned(grid.size(), 0);
+    vector<int> parent(grid.size(), -1), seen(grid.size(), -1), queue, route;
+    auto isOwned = [&](int cell, int side)
+    {
+        int bit;
+        return (ownerByte(owned, cols, cell, bit, side) & bit) != 0;
+    };
+
+    for (int attempt = 0; attempt < count * 50 && static_cast<int>(walls.size()) < count; ++attempt)
+    {
+        int x = rng.below(cols), y = rng.below(rows);
+        int side = rng.coin() ? DIR_RIGHT : DIR_DOWN;
+        if ((side == DIR_RIGHT && x == cols - 1) || (side == DIR_DOWN && y == rows - 1))
+            continue;
+        int a = grid.index(x, y), b = a + DIR_DY[side] * cols + DIR_DX[side];
+        if (!grid.hasWall(a, side) || isOwned(a, side))
+            continue;
+
+        // bounded BFS from b until it reaches a; parent links then lead a -> b
+        queue.assign(1, b);
+        seen[b] = attempt;
+        for (size_t head = 0; head < queue.size() && seen[a] != attempt && queue.size() < MAX_LOOP_SEARCH; ++head)
+        {
+            int cur = queue[head], cx = grid.xOf(cur), cy = grid.yOf(cur);
+            for (int d = 0; d < 4; ++d)
+            {
+                int n = cur + DIR_DY[d] * cols + DIR_DX[d];
+                if (grid.hasWall(cur, d) || !grid.inBounds(cx + DIR_DX[d], cy + DIR_DY[d]) || seen[n] == attempt)
+                    continue;
+                seen[n] = attempt;
+                parent[n] = cur;
+                queue.push_back(n);
+            }
+        }
+        if (seen[a] != attempt)
+            continue;
+        route.clear();
+        for (int cur = a; cur != b; cur = parent[cur])
+            route.push_back(cur);
+        bool clash = false;
+        for (int cur : route)
+            clash = clash || isOwned(cur, sideToward(cols, cur, parent[cur]));
+        if (clash)
+            continue;
+
+        int bit;
+        for (int cur : route)
+            ownerByte(owned, cols, cur, bit, sideToward(cols, cur, parent[cur])) |= bit;
+        ownerByte(owned, cols, a, bit, side) |= bit;
+
+        ShiftingWall w;
+        w.wallCell = w.gapCell = a;
+        w.wallSide = side;
+        w.gapSide = sideToward(cols, a, parent[a]);
+        w.period = 1.0f + rng.below(2001) / 1000.0f;
+        w.timer = rng.below(static_cast<int>(w.period * 1000.0f) + 1) / 1000.0f;
+        walls.push_back(w);
+    }
+}
+
+static void shift(MazeGrid &grid, ShiftingWall &w)
+{
+    w.shifted = !w.shifted;
+    if (w.shifted)
+    {
+        grid.carve(w.wallCell, w.wallSide);
+        grid.raiseWall(w.gapCell, w.gapSide);
+    }
+    else
+    {
+        grid.raiseWall(w.wallCell, w.wallSide);
+        grid.carve(w.gapCell, w.gapSide);
+    }
+}
+
+void ShiftingWalls::update(MazeGrid &grid, float dt, vector<int> &moved)
+{
+    for (int i = 0; i < size(); ++i)
+    {
+        ShiftingWall &w = walls[i];
+        w.timer -= dt;
+        // a long frame can fire a trap more than once; only the parity matters
+        bool fire = false;
+        while (w.timer <= 0.0f)
+        {
+            w.timer += w.period;
+            fire = !fire;
+        }
+        if (!fire)
+            continue;
+        shift(grid, w);
+        moved.push_back(i);
+    }
+}
+
+void ShiftingWalls::restore(MazeGrid &grid)
+{
+    for (ShiftingWall &w : walls)
+        if (w.shifted)
+            shift(grid, w);
+    walls.clear();
+}
+
+// ---------- D* Lite ---------- //
+// rhs of a cell: one step plus the best g among its open neighbours
+int DStarLite::bestNeighbourCost(int cell) const
+{
+    int best = INF;
+    for (int d = 0; d < 4; ++d)
+    {
+        int n = neighbour(cell, d);
+        if (n >= 0)
+            best = min(best, g[n] + 1);
+    }
+    return min(best, INF);
+}
+
+void DStarLite::computeKey(int cell, int &k1, int &k2) const
+{
+    k2 = min(g[cell], rhs[cell]);
+    k1 = k2 >= INF ? INF : k2 + heuristic(start, cell) + km;
+}
+
+void DStarLite::siftUp(int at)
+{
+    int cell = heap[at];
+    while (at > 0)
+    {
+        int up = (at - 1) / 2;
+        if (!before(cell, heap[up]))
+            break;
+        heap[at] = heap[up];
+        heapPos[heap[at]] = at;
+        at = up;
+    }
+    heap[at] = cell;
+    heapPos[cell] = at;
+}
+
+void DStarLite::siftDown(int at)
+{
+    int cell = heap[at], n = static_cast<int>(heap.size());
+    for (;;)
+    {
+        int child = 2 * at + 1;
+        if (child >= n)
+            break;
+        if (child + 1 < n && before(heap[child + 1], heap[child]))
+            child++;
+        if (!before(heap[child], cell))
+            break;
+        heap[at] = heap[child];
+        heapPos[heap[at]] = at;
+        at = child;
+    }
+    heap[at] = cell;
+    heapPos[cell] = at;
+}
+
+void DStarLite::push(int cell)
+{
+    computeKey(cell, key1[cell], key2[cell]);
+    heap.push_back(cell);
+    siftUp(static_cast<int>(heap.size()) - 1);
+}
+
+void DStarLite::remove(int cell)
+{
+    int at = heapPos[cell];
+    heapPos[cell] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (last == cell)
+        return;
+    heap[at] = last;
+    heapPos[last] = at;
+    siftUp(at);
+    siftDown(heapPos[last]);
+}
+
+int DStarLite::pop()
+{
+    int cell = heap[0];
+    remove(cell);
+    return cell;
+}
+
+void DStarLite::updateVertex(int cell)
+{
+    if (cell != goal)
+        rhs[cell] = bestNeighbourCost(cell);
+    if (heapPos[cell] >= 0)
+        remove(cell);
+    if (g[cell] != rhs[cell])
+        push(cell);
+}
+
+// exact distances for every cell, g == rhs everywhere and nothing queued
+void DStarLite::rebuild()
+{
+    for (int cell : heap)
+        heapPos[cell] = -1;
+    heap.clear();
+    fill(g.begin(), g.end(), INF);
+    int head = 0, tail = 0;
+    order[tail++] = goal;
+    g[goal] = 0;
+    while (head < tail)
+    {
+        int cell = order[head++];
+        for (int d = 0; d < 4; ++d)
+        {
+            int n = neighbour(cell, d);
+            if (n >= 0 && g[n] == INF)
+            {
+                g[n] = g[cell] + 1;
+                order[tail++] = n;
+            }
+        }
+    }
+    rhs = g;
+    km = 0;
+    lastStart = start;
+    rebuilds++;
+}
+
+void DStarLite::reset(const MazeGrid &maze, int startCell, int goalCell)
+{
+    grid = &maze;
+    start = lastStart = startCell;
+    goal = goalCell;
+    km = 0;
+    int cells = maze.size();
+    g.assign(cells, INF);
+    rhs.assign(cells, INF);
+    key1.assign(cells, 0);
+    key2.assign(cells, 0);
+    heapPos.assign(cells, -1);
+    heap.clear();
+    order.resize(cells);
+    repairBudget = max(256, cells / 16);
+    rebuilds = 0;
+    int cols = maze.getCols();
+    offset[DIR_UP] = -cols;
+    offset[DIR_DOWN] = cols;
+    offset[DIR_LEFT] = -1;
+    offset[DIR_RIGHT] = 1;
+    cellX.resize(cells);
+    cellY.resize(cells);
+    inside.resize(cells);
+    for (int i = 0; i < cells; ++i)
+    {
+        cellX[i] = i % cols;
+        cellY[i] = i / cols;
+        inside[i] = 0;
+        for (int d = 0; d < 4; ++d)
+            if (maze.inBounds(cellX[i] + DIR_DX[d], cellY[i] + DIR_DY[d]))
+                inside[i] |= 1 << d;
+    }
+    expandedTotal = 0;
+    if (cells == 0)
+        return;
+    rebuild();
+    expandedTotal = cells;
+}
+
+void DStarLite::moveStart(int cell)
+{
+    km += heuristic(lastStart, cell);
+    start = lastStart = cell;
+}
+
+void DStarLite::wallChanged(int cell, int side)
+{
+    updateVertex(cell);
+    updateVertex(cell + offset[side]);
+}
+
+void DStarLite::update()
+{
+    lastExpanded = 0;
+    for (;;)
+    {
+        int s1, s2;
+        computeKey(start, s1, s2);
+        if (heap.empty() || (!keyLess(key1[heap[0]], key2[heap[0]], s1, s2) && rhs[start] == g[start]))
+            break;
+        if (lastExpanded >= repairBudget)
+        {
+            rebuild();
+            lastExpanded += grid->size();
+            break;
+        }
+        int cell = heap[0];
+        int old1 = key1[cell], old2 = key2[cell], new1, new2;
+        computeKey(cell, new1, new2);
+        lastExpanded++;
+        if (keyLess(old1, old2, new1, new2))
+        {
+            // key went stale while the start moved: requeue with the new one
+            remove(cell);
+            push(cell);
+            continue;
+        }
+        pop();
+        if (g[cell] > rhs[cell])
+            g[cell] = rhs[cell];
+        else
+        {
+            g[cell] = INF;
+            updateVertex(cell);
+        }
+        for (int d = 0; d < 4; ++d)
+        {
+            int n = neighbour(cell, d);
+            if (n >= 0)
+                updateVertex(n);
+        }
+    }
+    expandedTotal += lastExpanded;
+}
+
+int DStarLite::nextMove() const
+{
+    if (start == goal || g[start] >= INF)
+        return -1;
+    int best = -1, bestCost = INF;
+    for (int d = 0; d < 4; ++d)
+    {
+        int n = neighbour(start, d);
+        if (n >= 0 && g[n] < bestCost)
+        {
+            bestCost = g[n];
+            best = d;
+        }
+    }
+    return best;
+}
+
+void DStarLite::path(vector<Coord> &out) const
+{
+    out.clear();
+    if (!grid || grid->empty() || g[start] >= INF)
+        return;
+    int cur = start;
+    out.push_back({grid->xOf(cur), grid->yOf(cur)});
+    // follow the cheapest neighbour; the bound only guards against a search
+    // left unfinished (update() not called since the last change)
+    for (int steps = 0; cur != goal && steps < g[start]; ++steps)
+    {
+        int next = -1, nextCost = INF;
+        for (int d = 0; d < 4; ++d)
+        {
+            int n = neighbour(cur, d);
+            if (n >= 0 && g[n] < nextCost)
+            {
+                nextCost = g[n];
+                next = n;
+            }
+        }
+        if (next < 0)
+            break;
+        cur = next;
+        out.push_back({grid->xOf(cur), grid->yOf(cur)});
+    }
+}
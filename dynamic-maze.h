@@ -0,0 +1,112 @@
+// Mazes whose walls move during play. ShiftingWalls slides a set of trap
+// walls back and forth on their own timers; DStarLite keeps the shortest
+// path from a moving start to a fixed goal up to date, repairing only the
+// part of its search that a moved wall or a start move invalidates.
+#pragma once
+
+#include "maze-core.h"
+#include <cstdlib>
+#include <vector>
+
+// A wall that slides: it opens while gap, a passage on the loop it would
+// close, shuts. Each side is (cell, side of that cell).
+struct ShiftingWall
+{
+    int wallCell = 0, wallSide = DIR_RIGHT; // closed as placed
+    int gapCell = 0, gapSide = DIR_RIGHT;   // open as placed
+    float period = 2.0f;                    // seconds between moves
+    float timer = 0.0f;                     // seconds until the next move
+    bool shifted = false;                   // wall open, gap closed
+};
+
+class ShiftingWalls
+{
+    std::vector<ShiftingWall> walls;
+
+public:
+    static constexpr size_t MAX_LOOP_SEARCH = 400; // cells searched for a wall's loop
+
+    // Picks up to count closed interior walls whose loop (the wall plus the
+    // path between its two cells) is short, and pairs each with the loop
+    // passage next to the wall's first cell. Loops never share a passage, so
+    // any mix of shifted and unshifted traps leaves every cell reachable; a
+    // perfect maze stays perfect. Periods are 1-3 s with random phases, and
+    // the same seed gives the same traps for the same maze.
+    void place(const MazeGrid &grid, unsigned long long seed, int count);
+    // Advances every timer by dt, moves the traps that fire and appends the
+    // index of each moved trap to moved.
+    void update(MazeGrid &grid, float dt, std::vector<int> &moved);
+    // puts every trap back the way place() found it and forgets them
+    void restore(MazeGrid &grid);
+
+    bool empty() const { return walls.empty(); }
+    int size() const { return static_cast<int>(walls.size()); }
+    const ShiftingWall &operator[](int i) const { return walls[i]; }
+};
+
+// D* Lite (Koenig & Likhachev) on the maze grid with unit step costs. It
+// searches backward from the goal, so g is the distance to the goal and the
+// start may move freely; the key modifier km keeps queued keys valid after a
+// move instead of rebuilding the queue.
+//
+// In a perfect maze one moved wall can re-root a whole subtree, and
+// repairing that cell by cell costs several times a plain BFS. So once a
+// repair has expanded more than repairBudget cells, update() drops the
+// queue and refills g from a BFS outward from the goal, which is also a
+// fully consistent D* Lite state. That caps the worst frame at roughly the
+// budget plus one BFS.
+class DStarLite
+{
+    const MazeGrid *grid = nullptr;
+    int start = 0, goal = 0, lastStart = 0, km = 0;
+    std::vector<int> g, rhs;
+    std::vector<int> cellX, cellY;     // cached coordinates for the heuristic
+    std::vector<unsigned char> inside; // sides of each cell that stay on the grid
+    int offset[4] = {0, 0, 0, 0};      // index step per side
+    // indexed binary heap of inconsistent cells ordered by (key1, key2)
+    std::vector<int> heap, heapPos, key1, key2;
+    std::vector<int> order; // BFS queue for rebuild()
+    int repairBudget = 0;
+    long long expandedTotal = 0, lastExpanded = 0, rebuilds = 0;
+
+    int heuristic(int a, int b) const { return std::abs(cellX[a] - cellX[b]) + std::abs(cellY[a] - cellY[b]); }
+    // open neighbour of cell on side d, or -1
+    int neighbour(int cell, int d) const
+    {
+        return ((inside[cell] >> d) & 1) && !grid->hasWall(cell, d) ? cell + offset[d] : -1;
+    }
+    int bestNeighbourCost(int cell) const;
+    bool keyLess(int k1a, int k2a, int k1b, int k2b) const { return k1a != k1b ? k1a < k1b : k2a < k2b; }
+    bool before(int a, int b) const { return keyLess(key1[a], key2[a], key1[b], key2[b]); }
+    void siftUp(int at);
+    void siftDown(int at);
+    void push(int cell);
+    void remove(int cell);
+    int pop();
+    void computeKey(int cell, int &k1, int &k2) const;
+    void updateVertex(int cell);
+    void rebuild();
+
+public:
+    static constexpr int INF = 1 << 29;
+
+    // binds to grid (which must outlive the solver) and solves from scratch
+    void reset(const MazeGrid &grid, int startCell, int goalCell);
+    // the player stepped to cell
+    void moveStart(int cell);
+    // grid changed at the wall between cell and its neighbour on side
+    void wallChanged(int cell, int side);
+    // repairs the search until the start is consistent again
+    void update();
+
+    // steps from the start to the goal, or -1 when the goal is walled off
+    int distance() const { return g[start] >= INF ? -1 : g[start]; }
+    // side of the first step toward the goal, -1 at the goal or when cut off
+    int nextMove() const;
+    // start to goal, empty when cut off
+    void path(std::vector<Coord> &out) const;
+
+    long long expanded() const { return expandedTotal; }
+    long long expandedLastUpdate() const { return lastExpanded; }
+    long long rebuildCount() const { return rebuilds; }
+};
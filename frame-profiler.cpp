@@ -0,0 +1,90 @@
+#include "frame-profiler.h"
+#include <algorithm>
+#include <cstdio>
+using namespace std;
+
+FrameProfiler::FrameProfiler(const vector<string> &phaseNames) : names(phaseNames), current(phaseNames.size(), 0.0f)
+{
+}
+
+// ---------- Frames ---------- //
+void FrameProfiler::beginFrame()
+{
+    frameStart = lastLap = Clock::now();
+    started = true;
+    fill(current.begin(), current.end(), 0.0f);
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!started)
+        return;
+    float total = static_cast<float>(chrono::duration<double, milli>(Clock::now() - frameStart).count());
+    int cols = columns();
+    if (samples.empty())
+        samples.resize(static_cast<size_t>(MAX_SAMPLES) * cols);
+    // once full, the oldest row is overwritten
+    int slot = (firstRow + rows) % MAX_SAMPLES;
+    if (rows == MAX_SAMPLES)
+        firstRow = (firstRow + 1) % MAX_SAMPLES;
+    else
+        ++rows;
+    float *r = &samples[static_cast<size_t>(slot) * cols];
+    r[0] = total;
+    copy(current.begin(), current.end(), r + 1);
+    ++frames;
+    started = false;
+}
+
+const float *FrameProfiler::row(int age) const
+{
+    int slot = (firstRow + rows - 1 - age) % MAX_SAMPLES;
+    return &samples[static_cast<size_t>(slot) * columns()];
+}
+
+// ---------- Rolling statistics ---------- //
+double FrameProfiler::average(int column) const
+{
+    int n = historySize();
+    if (n == 0)
+        return 0.0;
+    double sum = 0;
+    for (int age = 0; age < n; ++age)
+        sum += row(age)[column];
+    return sum / n;
+}
+
+double FrameProfiler::percentile(int column, double p) const
+{
+    int n = historySize();
+    if (n == 0)
+        return 0.0;
+    float window[HISTORY];
+    for (int age = 0; age < n; ++age)
+        window[age] = row(age)[column];
+    int k = min(n - 1, static_cast<int>(p * n));
+    nth_element(window, window + k, window + n);
+    return window[k];
+}
+
+// ---------- CSV ---------- //
+bool FrameProfiler::writeCsv(const string &path) const
+{
+    FILE *f = fopen(path.c_str(), "w");
+    if (!f)
+        return false;
+    fprintf(f, "frame,total_ms");
+    for (const string &name : names)
+        fprintf(f, ",%s_ms", name.c_str());
+    fprintf(f, "\n");
+    long long first = frames - rows;
+    for (int i = 0; i < rows; ++i)
+    {
+        const float *r = row(rows - 1 - i);
+        fprintf(f, "%lld", first + i);
+        for (int c = 0; c < columns(); ++c)
+            fprintf(f, ",%.4f", r[c]);
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0;
+}
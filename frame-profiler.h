@@ -0,0 +1,93 @@
+// Per-frame phase timings for the game loop. Top-level steps of the loop
+// are timed with lap(), which charges the time since the previous lap to a
+// phase; work inside functions is timed with a ProfileScope. endFrame()
+// closes the frame and stores one sample row. The
+// last HISTORY frames give rolling averages, 99th percentiles and the frame
+// time graph; up to MAX_SAMPLES rows are kept for the CSV dump.
+//
+// Building with MAZE_NO_PROFILER turns every MAZE_PROFILE_* macro into
+// nothing, so a release build pays no timer calls at all.
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class FrameProfiler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+    static constexpr int HISTORY = 240;       // frames in the rolling window
+    static constexpr int MAX_SAMPLES = 36000; // rows kept for the CSV, ten minutes at 60 FPS
+
+private:
+    std::vector<std::string> names;
+    std::vector<float> current; // this frame's ms per phase
+    std::vector<float> samples; // rows of (frame ms, then one column per phase)
+    int rows = 0, firstRow = 0; // ring of MAX_SAMPLES rows
+    long long frames = 0;
+    Clock::time_point frameStart, lastLap;
+    bool started = false;
+
+    int columns() const { return static_cast<int>(names.size()) + 1; }
+    const float *row(int age) const; // age 0 is the newest frame
+    double percentile(int column, double p) const;
+    double average(int column) const;
+
+public:
+    explicit FrameProfiler(const std::vector<std::string> &phaseNames);
+
+    // call once per loop iteration, before anything is timed
+    void beginFrame();
+    // stores the frame: its total time and every phase added since beginFrame
+    void endFrame();
+    void add(int phase, double ms) { current[phase] += static_cast<float>(ms); }
+    // charges the time since beginFrame() or the previous lap to phase
+    void lap(int phase)
+    {
+        Clock::time_point now = Clock::now();
+        add(phase, std::chrono::duration<double, std::milli>(now - lastLap).count());
+        lastLap = now;
+    }
+
+    int phaseCount() const { return static_cast<int>(names.size()); }
+    const std::string &phaseName(int phase) const { return names[phase]; }
+    // over the last HISTORY frames; phase -1 is the whole frame
+    double averageMs(int phase) const { return average(phase + 1); }
+    double p99Ms(int phase) const { return percentile(phase + 1, 0.99); }
+    // whole-frame time age frames ago (0 = last frame), for the graph
+    float frameMs(int age) const { return age < historySize() ? row(age)[0] : 0.0f; }
+    int historySize() const { return rows < HISTORY ? rows : HISTORY; }
+    long long frameCount() const { return frames; }
+
+    // frame,total_ms,<phase>_ms,... one line per kept frame, oldest first
+    bool writeCsv(const std::string &path) const;
+};
+
+// adds the time from construction to destruction to one phase
+class ProfileScope
+{
+    FrameProfiler &profiler;
+    int phase;
+    FrameProfiler::Clock::time_point start;
+
+public:
+    ProfileScope(FrameProfiler &p, int ph) : profiler(p), phase(ph), start(FrameProfiler::Clock::now()) {}
+    ~ProfileScope() { profiler.add(phase, std::chrono::duration<double, std::milli>(FrameProfiler::Clock::now() - start).count()); }
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#define MAZE_PROFILE_CONCAT2(a, b) a##b
+#define MAZE_PROFILE_CONCAT(a, b) MAZE_PROFILE_CONCAT2(a, b)
+#ifndef MAZE_NO_PROFILER
+#define MAZE_PROFILE_BEGIN_FRAME(profiler) (profiler).beginFrame()
+#define MAZE_PROFILE_END_FRAME(profiler) (profiler).endFrame()
+#define MAZE_PROFILE_LAP(profiler, phase) (profiler).lap(phase)
+#define MAZE_PROFILE_SCOPE(profiler, phase) ProfileScope MAZE_PROFILE_CONCAT(profileScope, __LINE__)(profiler, phase)
+#else
+#define MAZE_PROFILE_BEGIN_FRAME(profiler) ((void)0)
+#define MAZE_PROFILE_END_FRAME(profiler) ((void)0)
+#define MAZE_PROFILE_LAP(profiler, phase) ((void)0)
+#define MAZE_PROFILE_SCOPE(profiler, phase) ((void)0)
+#endif
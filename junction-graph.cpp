@@ -0,0 +1,212 @@
+#include "junction-graph.h"
+#include "trace-events.h"
+#include <algorithm>
+using namespace std;
+
+// the one open side of a corridor cell other than the one it was entered by;
+// -1 when the cell is not a corridor after all, which happens when a wall is
+// open on one side only (a border opening from clearWall, or an
+// inconsistent grid)
+static int corridorExit(unsigned char cell, int entered)
+{
+    int open = ~cell & WALL_MASK & ~(1 << entered);
+    for (int d = 0; d < 4; ++d)
+        if (open == (1 << d))
+            return d;
+    return -1;
+}
+
+// ---------- Build ---------- //
+void JunctionGraph::build(const MazeGrid &grid, int start, int goal)
+{
+    MAZE_TRACE_SCOPE("JunctionGraph::build");
+    rows = grid.getRows();
+    cols = grid.getCols();
+    int cells = grid.size();
+    const unsigned char *cell = grid.bytes().data();
+    nodeOf.assign(cells, -1);
+    nodeCell.clear();
+    sides.clear();
+    for (int i = 0; i < cells; ++i)
+    {
+        int open = OPEN_SIDES[cell[i] & WALL_MASK];
+        if (open != 2 || i == start || i == goal)
+        {
+            nodeOf[i] = static_cast<int>(nodeCell.size());
+            nodeCell.push_back(i);
+            sides.push_back(static_cast<unsigned char>(open));
+        }
+    }
+
+    // walk each corridor once, from whichever end is reached first, and
+    // record the edge at both ends
+    edges.assign(nodeCell.size() * 4, Edge());
+    for (int n = 0; n < nodeCount(); ++n)
+    {
+        for (int d = 0; d < 4; ++d)
+        {
+            int from = nodeCell[n];
+            if (grid.hasWall(from, d) || edges[n * 4 + d].to >= 0)
+                continue;
+            int cur = from, dir = d, length = 0;
+            int x = grid.xOf(from), y = grid.yOf(from);
+            for (;;)
+            {
+                x += DIR_DX[dir];
+                y += DIR_DY[dir];
+                if (!grid.inBounds(x, y))
+                {
+                    cur = -1; // an opening in the border leads nowhere
+                    break;
+                }
+                cur += DIR_DY[dir] * cols + DIR_DX[dir];
+                length++;
+                if (nodeOf[cur] >= 0)
+                    break;
+                dir = corridorExit(cell[cur], OppositeDir(dir));
+                if (dir < 0)
+                {
+                    cur = -1; // the way back is walled off: not a corridor to walk
+                    break;
+                }
+            }
+            if (cur < 0)
+                continue;
+            edges[n * 4 + d] = {nodeOf[cur], length};
+            edges[nodeOf[cur] * 4 + OppositeDir(dir)] = {n, length};
+        }
+    }
+}
+
+int JunctionGraph::edgeCount() const
+{
+    int ends = 0;
+    for (const Edge &e : edges)
+        if (e.to >= 0)
+            ends++;
+    return ends / 2;
+}
+
+MazeMetrics JunctionGraph::shape() const
+{
+    MazeMetrics m;
+    for (unsigned char s : sides)
+    {
+        if (s == 1)
+            m.deadEnds++;
+        else if (s >= 3)
+            m.branches++;
+    }
+    return m;
+}
+
+// ---------- Routing ---------- //
+int JunctionGraph::shortestRoute(int from, int to, long long *expanded)
+{
+    int nodes = nodeCount();
+    if (static_cast<int>(dist.size()) != nodes)
+    {
+        dist.assign(nodes, 0);
+        parentNode.assign(nodes, -1);
+        parentSide.assign(nodes, 0);
+    }
+    seen.begin(nodes);
+    closed.begin(nodes);
+    open.clear();
+    route.clear();
+    routeFrom = -1;
+    auto later = [](const OpenEntry &a, const OpenEntry &b)
+    { return a.dist > b.dist; };
+
+    seen.set(from);
+    dist[from] = 0;
+    open.push_back({0, from});
+    long long popped = 0;
+    while (!open.empty())
+    {
+        pop_heap(open.begin(), open.end(), later);
+        OpenEntry top = open.back();
+        open.pop_back();
+        if (closed.has(top.node))
+            continue;
+        closed.set(top.node);
+        if (top.node == to)
+            break;
+        popped++;
+        for (int d = 0; d < 4; ++d)
+        {
+            const Edge &e = edges[top.node * 4 + d];
+            if (e.to < 0 || closed.has(e.to))
+                continue;
+            int g = top.dist + e.length;
+            if (seen.has(e.to) && dist[e.to] <= g)
+                continue;
+            seen.set(e.to);
+            dist[e.to] = g;
+            parentNode[e.to] = top.node;
+            parentSide[e.to] = static_cast<unsigned char>(d);
+            open.push_back({g, e.to});
+            push_heap(open.begin(), open.end(), later);
+        }
+    }
+    if (expanded)
+        *expanded = popped;
+    if (!closed.has(to))
+        return -1;
+
+    for (int n = to; n != from; n = parentNode[n])
+    {
+        route.push_back(parentSide[n]);
+        route.push_back(parentNode[n]);
+    }
+    reverse(route.begin(), route.end());
+    routeFrom = from;
+    return dist[to];
+}
+
+void JunctionGraph::expandRoute(const MazeGrid &grid, vector<Coord> &path) const
+{
+    path.clear();
+    if (routeFrom < 0)
+        return;
+    const unsigned char *cell = grid.bytes().data();
+    path.push_back({grid.xOf(nodeCell[routeFrom]), grid.yOf(nodeCell[routeFrom])});
+    for (size_t k = 0; k < route.size(); k += 2)
+    {
+        int cur = nodeCell[route[k]], dir = route[k + 1];
+        for (;;)
+        {
+            cur += DIR_DY[dir] * cols + DIR_DX[dir];
+            path.push_back({grid.xOf(cur), grid.yOf(cur)});
+            if (nodeOf[cur] >= 0)
+                break;
+            // build() keeps no edge through such a cell, so this only guards
+            dir = corridorExit(cell[cur], OppositeDir(dir));
+            if (dir < 0)
+                break;
+        }
+    }
+}
+
+size_t JunctionGraph::memoryBytes() const
+{
+    return vectorBytes(nodeOf) + vectorBytes(nodeCell) + vectorBytes(sides) + vectorBytes(edges) + vectorBytes(open) +
+           vectorBytes(dist) + vectorBytes(parentNode) + vectorBytes(parentSide) + seen.bytes() + closed.bytes() + vectorBytes(route);
+}
+
+// ---------- Solver front end ---------- //
+long long JunctionSolver::search(const MazeGrid &grid, int start, int goal, vector<Coord> &path)
+{
+    long long built = 0;
+    if (grid.id() != builtId || grid.editCount() != builtEdits || graph.nodeAt(start) < 0 || graph.nodeAt(goal) < 0)
+    {
+        graph.build(grid, start, goal);
+        builtId = grid.id();
+        builtEdits = grid.editCount();
+        built = grid.size();
+    }
+    long long expanded = 0;
+    if (graph.shortestRoute(graph.nodeAt(start), graph.nodeAt(goal), &expanded) >= 0)
+        graph.expandRoute(grid, path);
+    return built + expanded;
+}
@@ -0,0 +1,85 @@
+// Corridor-compressed view of a maze. Most cells of a perfect maze are
+// corridor cells with exactly two openings; the junction graph keeps only
+// the cells where a choice is made or a walk ends (junctions, dead ends, and
+// the start and goal cells), joined by edges weighted with the corridor
+// length between them. Searches run on the nodes and a route is turned back
+// into cells only when a caller needs the cell path.
+#pragma once
+
+#include "maze-core.h"
+#include "maze-solvers.h"
+#include <vector>
+
+class JunctionGraph
+{
+public:
+    struct Edge
+    {
+        int to = -1;    // node at the far end, -1 behind a wall
+        int length = 0; // steps along the corridor
+    };
+
+private:
+    int rows = 0, cols = 0;
+    std::vector<int> nodeOf;            // cell -> node, -1 for corridor cells
+    std::vector<int> nodeCell;          // node -> cell
+    std::vector<unsigned char> sides;   // open sides of each node's cell
+    std::vector<Edge> edges;            // 4 per node, indexed by side
+
+    // Dijkstra scratch, reused between queries
+    struct OpenEntry
+    {
+        int dist, node;
+    };
+    std::vector<OpenEntry> open;
+    std::vector<int> dist, parentNode;
+    std::vector<unsigned char> parentSide;
+    EpochMarks seen, closed;
+    std::vector<int> route;             // node, side taken, node, side taken, ...
+    int routeFrom = -1;                 // -1 until a route is found
+
+public:
+    // start and goal are kept as nodes even when they sit in a corridor
+    void build(const MazeGrid &grid, int start, int goal);
+    // (0,0) to the bottom-right cell
+    void build(const MazeGrid &grid) { build(grid, 0, grid.size() - 1); }
+
+    int nodeCount() const { return static_cast<int>(nodeCell.size()); }
+    int edgeCount() const;
+    int nodeAt(int cell) const { return nodeOf[cell]; }
+    int cellOf(int node) const { return nodeCell[node]; }
+    const Edge &edge(int node, int side) const { return edges[node * 4 + side]; }
+
+    // Dead ends and branches (3+ openings) read off the nodes alone; every
+    // such cell is a node, so difficultyScore gives evaluateDifficulty's score
+    MazeMetrics shape() const;
+    float difficulty() const { return difficultyScore(rows, cols, shape()); }
+
+    // Shortest route between two nodes. Returns its length in steps, or -1
+    // when to cannot be reached, and keeps the route for expandRoute().
+    int shortestRoute(int from, int to, long long *expanded = nullptr);
+    // cells of the last route found, walking each corridor in turn
+    void expandRoute(const MazeGrid &grid, std::vector<Coord> &path) const;
+    // the graph plus the search scratch
+    size_t memoryBytes() const;
+};
+
+// MazeSolver front end: builds the graph for the maze, routes on it and
+// expands the route. The graph is kept while the grid's walls are unchanged
+// (same MazeGrid::id() and editCount()) and both endpoints are nodes of it,
+// so later queries on the same maze skip the O(cells) build.
+// SolveStats::expanded counts every cell the build walks plus the graph
+// nodes the route expands.
+class JunctionSolver : public MazeSolver
+{
+    JunctionGraph graph;
+    unsigned long long builtId = 0, builtEdits = 0; // grid version the graph was built from
+
+public:
+    const char *name() const override { return "junction"; }
+    size_t memoryBytes() const override { return graph.memoryBytes(); }
+    const JunctionGraph &lastGraph() const { return graph; }
+
+protected:
+    long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) override;
+};
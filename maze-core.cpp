@@ -0,0 +1,510 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "maze-core.h"
+#include "maze-solvers.h"
+#include "trace-events.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <chrono>
+using namespace std;
+
+atomic<long long> poolSlabAllocations(0);
+
+// ---------- Maze generation (iterative DFS) ---------- //
+void generateFullMaze(MazeGrid &grid, int rows, int cols, unsigned long long seed, MazeMetrics *metrics)
+{
+    MazeRng rng(seed);
+    MazeMetrics shape;
+    grid.reset(rows, cols);
+    // per-thread scratch: after the first maze of a given size these reuse
+    // their slabs / words instead of allocating per cell
+    static thread_local Stack<int> dfsStack;
+    static thread_local VisitBitset visited;
+    dfsStack.clear();
+    visited.reset(rows, cols);
+
+    grid.setPath(0);
+    visited.mark(0);
+    dfsStack.push(0);
+
+    while (!dfsStack.empty())
+    {
+        int cur = dfsStack.top();
+        int cx = grid.xOf(cur), cy = grid.yOf(cur);
+        int dirs[4];
+        int dirCount = 0;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = cx + DIR_DX[d], ny = cy + DIR_DY[d];
+            if (grid.inBounds(nx, ny) && !visited.isVisited(nx, ny))
+                dirs[dirCount++] = d;
+        }
+        if (dirCount > 0)
+        {
+            int d = dirs[rng.below(dirCount)];
+            int next = cur + DIR_DY[d] * cols + DIR_DX[d];
+            grid.carve(cur, d, shape);
+            grid.setPath(next);
+            visited.mark(next);
+            dfsStack.push(next);
+        }
+        else
+        {
+            dfsStack.pop();
+        }
+    }
+    grid.setPath(0);
+    grid.setPath(grid.index(cols - 1, rows - 1));
+    if (metrics)
+        *metrics = shape;
+}
+
+// ---------- Eller's algorithm (streaming) ---------- //
+// Sets of the current row live in a small union-find over column positions.
+static int findSet(vector<int> &parent, int x)
+{
+    while (parent[x] != x)
+    {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+void generateEllerRows(int rows, int cols, unsigned long long seed, const MazeRowSink &sink, MazeMetrics *metrics)
+{
+    if (metrics)
+        *metrics = MazeMetrics();
+    if (rows <= 0 || cols <= 0)
+        return;
+    MazeRng rng(seed);
+    vector<unsigned char> row(cols);
+    vector<int> parent(cols), members(cols), pick(cols), firstDown(cols), prevRoot(cols);
+    vector<unsigned char> northOpen(cols, 0), down(cols);
+    for (int x = 0; x < cols; ++x)
+        parent[x] = x;
+
+    for (int y = 0; y < rows; ++y)
+    {
+        bool lastRow = y == rows - 1;
+        for (int x = 0; x < cols; ++x)
+            row[x] = static_cast<unsigned char>(WALL_MASK | CELL_PATH);
+        for (int x = 0; x < cols; ++x)
+            if (northOpen[x])
+                row[x] &= ~(1 << DIR_UP);
+
+        // join neighbours from different sets; the last row joins all of them
+        for (int x = 0; x + 1 < cols; ++x)
+        {
+            int a = findSet(parent, x), b = findSet(parent, x + 1);
+            if (a == b || (!lastRow && rng.coin()))
+                continue;
+            parent[b] = a;
+            row[x] &= ~(1 << DIR_RIGHT);
+            row[x + 1] &= ~(1 << DIR_LEFT);
+        }
+
+        if (!lastRow)
+        {
+            // random drops, then one forced drop for every set that has none;
+            // the forced cell is a uniformly chosen member (reservoir sampling)
+            for (int x = 0; x < cols; ++x)
+                members[x] = 0;
+            for (int x = 0; x < cols; ++x)
+            {
+                int r = findSet(parent, x);
+                down[x] = rng.coin();
+                if (++members[r] == 1 || rng.below(members[r]) == 0)
+                    pick[r] = x;
+            }
+            for (int x = 0; x < cols; ++x)
+                members[x] = 0;
+            for (int x = 0; x < cols; ++x)
+                if (down[x])
+                    members[findSet(parent, x)] = 1;
+            for (int x = 0; x < cols; ++x)
+            {
+                int r = findSet(parent, x);
+                if (!members[r])
+                {
+                    down[pick[r]] = 1;
+                    members[r] = 1;
+                }
+            }
+            for (int x = 0; x < cols; ++x)
+                if (down[x])
+                    row[x] &= ~(1 << DIR_DOWN);
+
+            // next row: cells below a drop inherit the set, the rest start fresh
+            for (int x = 0; x < cols; ++x)
+                firstDown[x] = -1;
+            for (int x = 0; x < cols; ++x)
+                prevRoot[x] = findSet(parent, x);
+            for (int x = 0; x < cols; ++x)
+            {
+                parent[x] = x;
+                northOpen[x] = down[x];
+            }
+            for (int x = 0; x < cols; ++x)
+            {
+                if (!down[x])
+                    continue;
+                int r = prevRoot[x];
+                if (firstDown[r] < 0)
+                    firstDown[r] = x;
+                else
+                    parent[x] = firstDown[r];
+            }
+        }
+        // a row's walls are final here, so its shape is counted while it is
+        // still in cache
+        if (metrics)
+        {
+            MazeShapeCounts counts = countShape(row.data(), row.size());
+            metrics->deadEnds += static_cast<int>(counts.deadEnds);
+            metrics->branches += static_cast<int>(counts.junctions);
+        }
+        sink(y, row.data(), cols);
+    }
+}
+
+void generateEllerMaze(MazeGrid &grid, int rows, int cols, unsigned long long seed, MazeMetrics *metrics)
+{
+    grid.reset(rows, cols);
+    generateEllerRows(rows, cols, seed, [&grid](int y, const unsigned char *row, int n)
+                      { copy(row, row + n, grid.rowData(y)); }, metrics);
+}
+
+// ---------- Growing tree ---------- //
+void generateGrowingTree(MazeGrid &grid, int rows, int cols, unsigned long long seed, float newestBias, MazeMetrics *metrics)
+{
+    MazeRng rng(seed);
+    MazeMetrics shape;
+    grid.reset(rows, cols);
+    static thread_local vector<int> active;
+    static thread_local VisitBitset visited;
+    active.clear();
+    visited.reset(rows, cols);
+    // compared against the top 32 bits of a draw, so the bias is exact at 0 and 1
+    unsigned long long newestCut = static_cast<unsigned long long>(max(0.0f, min(1.0f, newestBias)) * 4294967296.0);
+
+    int start = rng.below(rows * cols);
+    grid.setPath(start);
+    visited.mark(start);
+    active.push_back(start);
+
+    while (!active.empty())
+    {
+        int slot = (rng() >> 32) < newestCut ? static_cast<int>(active.size()) - 1 : rng.below(static_cast<int>(active.size()));
+        int cur = active[slot];
+        int cx = grid.xOf(cur), cy = grid.yOf(cur);
+        int dirs[4];
+        int dirCount = 0;
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = cx + DIR_DX[d], ny = cy + DIR_DY[d];
+            if (grid.inBounds(nx, ny) && !visited.isVisited(nx, ny))
+                dirs[dirCount++] = d;
+        }
+        if (dirCount > 0)
+        {
+            int d = dirs[rng.below(dirCount)];
+            int next = cur + DIR_DY[d] * cols + DIR_DX[d];
+            grid.carve(cur, d, shape);
+            grid.setPath(next);
+            visited.mark(next);
+            active.push_back(next);
+        }
+        else
+        {
+            // swap-remove: exact DFS at bias 1, where slot is always the back
+            active[slot] = active.back();
+            active.pop_back();
+        }
+    }
+    if (metrics)
+        *metrics = shape;
+}
+
+void generateMaze(MazeGrid &grid, int rows, int cols, unsigned long long seed, MazeAlgorithm algo, MazeMetrics *metrics)
+{
+    MAZE_TRACE_SCOPE_DETAIL("generateMaze", algo == ALGO_ELLER ? "eller" : "dfs", -1);
+    if (algo == ALGO_ELLER)
+        generateEllerMaze(grid, rows, cols, seed, metrics);
+    else
+        generateFullMaze(grid, rows, cols, seed, metrics);
+}
+
+unsigned long long mazeDigest(const MazeGrid &grid)
+{
+    unsigned long long h = 0xCBF29CE484222325ULL;
+    const unsigned char dims[8] = {
+        static_cast<unsigned char>(grid.getRows()), static_cast<unsigned char>(grid.getRows() >> 8),
+        static_cast<unsigned char>(grid.getRows() >> 16), static_cast<unsigned char>(grid.getRows() >> 24),
+        static_cast<unsigned char>(grid.getCols()), static_cast<unsigned char>(grid.getCols() >> 8),
+        static_cast<unsigned char>(grid.getCols() >> 16), static_cast<unsigned char>(grid.getCols() >> 24)};
+    for (unsigned char b : dims)
+        h = (h ^ b) * 0x100000001B3ULL;
+    for (unsigned char b : grid.bytes())
+        h = (h ^ (b & WALL_MASK)) * 0x100000001B3ULL;
+    return h;
+}
+
+string formatSeed(unsigned long long seed)
+{
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llX", seed);
+    return buf;
+}
+
+bool parseSeed(const string &text, unsigned long long &seed)
+{
+    if (text.empty() || text.size() > 16)
+        return false;
+    unsigned long long v = 0;
+    for (char ch : text)
+    {
+        int digit;
+        if (ch >= '0' && ch <= '9')
+            digit = ch - '0';
+        else if (ch >= 'a' && ch <= 'f')
+            digit = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F')
+            digit = ch - 'A' + 10;
+        else
+            return false;
+        v = (v << 4) | static_cast<unsigned long long>(digit);
+    }
+    seed = v;
+    return true;
+}
+
+bool isPerfectMaze(const MazeGrid &grid)
+{
+    if (grid.empty())
+        return false;
+    // a spanning tree has exactly cells - 1 passages and reaches every cell
+    long long openSides = 0;
+    for (int i = 0; i < grid.size(); ++i)
+        openSides += grid.openSides(i);
+    if (openSides != 2LL * (grid.size() - 1))
+        return false;
+    static thread_local VisitBitset visited;
+    static thread_local Stack<int> todo;
+    visited.reset(grid.getRows(), grid.getCols());
+    todo.clear();
+    todo.push(0);
+    visited.mark(0);
+    int reached = 1;
+    while (!todo.empty())
+    {
+        int cur = todo.top();
+        todo.pop();
+        int cx = grid.xOf(cur), cy = grid.yOf(cur);
+        for (int d = 0; d < 4; ++d)
+        {
+            int nx = cx + DIR_DX[d], ny = cy + DIR_DY[d];
+            if (grid.hasWall(cur, d) || !grid.inBounds(nx, ny))
+                continue;
+            int next = grid.index(nx, ny);
+            if (visited.isVisited(next))
+                continue;
+            visited.mark(next);
+            reached++;
+            todo.push(next);
+        }
+    }
+    return reached == grid.size();
+}
+
+// ---------- BFS solver ---------- //
+vector<Coord> BFSSolve(const MazeGrid &grid)
+{
+    // the BfsSolver keeps its queue, parents and marks between calls
+    static thread_local BfsSolver solver;
+    vector<Coord> path;
+    solver.solve(grid, path);
+    return path;
+}
+
+// ---------- Evaluate difficulty quick helper ---------- //
+static const float DIFFICULTY_RAW_FLOOR = 30.0f;
+static const float DIFFICULTY_RAW_SCALE = 6.0f;
+
+float evaluateDifficulty(const MazeGrid &grid)
+{
+    MAZE_TRACE_SCOPE("evaluateDifficulty");
+    if (grid.empty())
+        return 0.0f;
+    MazeShapeCounts counts = countShape(grid.bytes().data(), grid.bytes().size());
+    MazeMetrics m;
+    m.deadEnds = static_cast<int>(counts.deadEnds);
+    m.branches = static_cast<int>(counts.junctions);
+    return difficultyScore(grid.getRows(), grid.getCols(), m);
+}
+
+// The one place the counts become a score, so the fused and the full-pass
+// paths round identically.
+float difficultyScore(int R, int C, const MazeMetrics &m)
+{
+    if (R <= 0 || C <= 0)
+        return 0.0f;
+    // the furthest cell from the start is always the opposite corner
+    int total = R * C, maxCoord = R - 1 + C - 1;
+    float deadRatio = static_cast<float>(m.deadEnds) / static_cast<float>(total);
+    float branchRatio = static_cast<float>(m.branches) / static_cast<float>(total);
+    float pathRatio = static_cast<float>(maxCoord) / static_cast<float>(R + C);
+    float raw = (deadRatio * 40.0f) + (branchRatio * 35.0f) + (pathRatio * 25.0f);
+    // perfect mazes land between ~31 (DFS) and ~47 (Prim-like) raw; stretch
+    // that onto 0..100 so every difficulty band can actually be reached
+    float score = (raw - DIFFICULTY_RAW_FLOOR) * DIFFICULTY_RAW_SCALE;
+    return max(0.0f, min(score, 100.0f));
+}
+
+void difficultyBand(DifficultyLevel level, float &minScore, float &maxScore)
+{
+    if (level == DIFF_EASY)
+    {
+        minScore = 0;
+        maxScore = 33;
+    }
+    else if (level == DIFF_MEDIUM)
+    {
+        minScore = 34;
+        maxScore = 66;
+    }
+    else
+    {
+        minScore = 67;
+        maxScore = 100;
+    }
+}
+
+// ---------- Difficulty-targeted generation ---------- //
+// Mean evaluateDifficulty of growing-tree mazes (30x30) at bias 0.5, 0.55,
+// ..., 1.0; lower bias means more dead ends and a higher score. Below 0.5
+// the score stops rising, so that is the bottom of the knob.
+static const float BIAS_LOW = 0.5f, BIAS_STEP = 0.05f;
+static const float SCORE_AT_BIAS[11] = {93.6f, 91.9f, 89.3f, 84.9f, 79.5f, 72.0f, 62.5f, 51.5f, 39.7f, 25.6f, 10.5f};
+
+static float biasForScore(float target)
+{
+    if (target >= SCORE_AT_BIAS[0])
+        return BIAS_LOW;
+    for (int k = 1; k < 11; ++k)
+        if (target >= SCORE_AT_BIAS[k])
+        {
+            float t = (SCORE_AT_BIAS[k - 1] - target) / (SCORE_AT_BIAS[k - 1] - SCORE_AT_BIAS[k]);
+            return BIAS_LOW + (k - 1 + t) * BIAS_STEP;
+        }
+    return 1.0f;
+}
+
+bool generateForDifficulty(MazeGrid &grid, int rows, int cols, unsigned long long seed, float minScore, float maxScore, TargetReport *report)
+{
+    MAZE_TRACE_SCOPE("generateForDifficulty");
+    const int maxAttempts = 8;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    // start at the calibrated bias for the band centre, then bisect on the
+    // bias, which moves the score monotonically
+    float lo = BIAS_LOW, hi = 1.0f;
+    float bias = biasForScore((minScore + maxScore) / 2.0f);
+    float bestBias = bias, bestDist = -1.0f, score = 0.0f;
+    unsigned long long bestSeed = seed;
+    int attempt = 0;
+    bool inBand = false;
+    while (attempt < maxAttempts && !inBand)
+    {
+        unsigned long long attemptSeed = deriveSeed(seed, static_cast<unsigned long long>(attempt));
+        MazeMetrics shape;
+        generateGrowingTree(grid, rows, cols, attemptSeed, bias, &shape);
+        score = difficultyScore(rows, cols, shape);
+        attempt++;
+        float dist = score < minScore ? minScore - score : (score > maxScore ? score - maxScore : 0.0f);
+        if (bestDist < 0 || dist < bestDist)
+        {
+            bestDist = dist;
+            bestBias = bias;
+            bestSeed = attemptSeed;
+        }
+        inBand = dist == 0.0f;
+        if (score > maxScore)
+        {
+            lo = bias;
+            bias = (bias + hi) / 2.0f;
+        }
+        else if (score < minScore)
+        {
+            hi = bias;
+            bias = (lo + bias) / 2.0f;
+        }
+    }
+    if (!inBand)
+    {
+        // no attempt made it: rebuild the closest one rather than keeping a
+        // copy of every candidate
+        MazeMetrics shape;
+        generateGrowingTree(grid, rows, cols, bestSeed, bestBias, &shape);
+        score = difficultyScore(rows, cols, shape);
+    }
+    if (report)
+    {
+        report->attempts = attempt;
+        report->ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        report->score = score;
+        report->bias = inBand ? bias : bestBias;
+        report->inBand = inBand;
+    }
+    return inBand;
+}
+
+// ---------- Score file I/O ---------- //
+void SaveScoreToFile(const PlayerScore &p, const string &path)
+{
+    MAZE_TRACE_SCOPE("SaveScoreToFile");
+    ofstream f(path, ios::app);
+    if (!f.is_open())
+        return;
+    f << p.name << "," << p.time << "," << (int)p.diff << "," << p.date << "\n";
+    f.close();
+}
+void LoadScoresFromFile(ScoreBST &easy, ScoreBST &medium, ScoreBST &hard, const string &path)
+{
+    MAZE_TRACE_SCOPE("LoadScoresFromFile");
+    ifstream f(path);
+    if (!f.is_open())
+        return;
+    string line;
+    while (getline(f, line))
+    {
+        stringstream ss(line);
+        string name, timeS, diffS, date;
+        if (!getline(ss, name, ','))
+            continue;
+        if (!getline(ss, timeS, ','))
+            continue;
+        if (!getline(ss, diffS, ','))
+            continue;
+        if (!getline(ss, date))
+            continue;
+        try
+        {
+            float t = stof(timeS);
+            int di = stoi(diffS);
+            PlayerScore ps(name, t, (DifficultyLevel)di, date);
+            if (ps.diff == DIFF_EASY)
+                easy.add(ps);
+            else if (ps.diff == DIFF_MEDIUM)
+                medium.add(ps);
+            else
+                hard.add(ps);
+        }
+        catch (...)
+        {
+            continue;
+        }
+    }
+    f.close();
+}
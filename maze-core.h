@@ -0,0 +1,670 @@
+// Headless maze engine: data structures, generation, solving, scoring and
+// score file I/O. Nothing in here depends on raylib, so it can be linked
+// into the game as well as into command-line tools such as mazegen.
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ---------- Enums ---------- //
+enum DifficultyLevel
+{
+    DIFF_EASY,
+    DIFF_MEDIUM,
+    DIFF_HARD
+};
+
+// ---------- Seeds and RNG ---------- //
+// splitmix64 finaliser, a cheap bijective 64-bit mix
+inline unsigned long long mixSeed(unsigned long long z)
+{
+    z += 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+// Seed of child stream number stream of seed (candidate i, chunk k, ...).
+inline unsigned long long deriveSeed(unsigned long long seed, unsigned long long stream)
+{
+    return mixSeed(seed ^ mixSeed(stream));
+}
+
+// xoshiro256** seeded through splitmix64. Unlike std::mt19937 plus the
+// std distributions, its output is fully specified, so a seed produces the
+// same maze with every compiler and standard library.
+class MazeRng
+{
+    unsigned long long s[4];
+
+    static unsigned long long rotl(unsigned long long x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    typedef unsigned long long result_type;
+
+    explicit MazeRng(unsigned long long seed = 0) { reseed(seed); }
+    void reseed(unsigned long long seed)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            seed += 0x9E3779B97F4A7C15ULL;
+            s[i] = mixSeed(seed - 0x9E3779B97F4A7C15ULL);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~0ULL; }
+    result_type operator()()
+    {
+        unsigned long long r = rotl(s[1] * 5, 7) * 9, t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return r;
+    }
+    // uniform in [0, n), n > 0, without modulo bias
+    int below(int n)
+    {
+        unsigned long long limit = ~0ULL - ~0ULL % static_cast<unsigned long long>(n);
+        unsigned long long r;
+        do
+            r = (*this)();
+        while (r >= limit);
+        return static_cast<int>(r % static_cast<unsigned long long>(n));
+    }
+    bool coin() { return ((*this)() >> 63) != 0; }
+};
+
+// ---------- Node pool (slab allocator) ---------- //
+// Number of slabs every NodePool has taken from the global heap, across all
+// threads. Once the containers are warmed up this stops moving.
+extern std::atomic<long long> poolSlabAllocations;
+
+// Hands out fixed-size nodes from 1024-node slabs. Freed nodes go on a free
+// list, and reset() forgets every node at once while keeping the slabs, so a
+// container that is cleared between mazes never goes back to the heap.
+template <typename Node>
+class NodePool
+{
+    static const int SLAB_NODES = 1024;
+    struct Slot
+    {
+        alignas(Node) unsigned char bytes[sizeof(Node)];
+    };
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    int slabIndex = 0; // slab currently handing out fresh slots
+    int used = 0;      // fresh slots taken from slabs[slabIndex]
+    void *freeList = nullptr;
+
+public:
+    template <typename... Args>
+    Node *create(Args &&...args)
+    {
+        void *mem;
+        if (freeList)
+        {
+            mem = freeList;
+            freeList = *static_cast<void **>(freeList);
+        }
+        else
+        {
+            if (slabIndex < static_cast<int>(slabs.size()) && used == SLAB_NODES)
+            {
+                ++slabIndex;
+                used = 0;
+            }
+            if (slabIndex == static_cast<int>(slabs.size()))
+            {
+                slabs.emplace_back(new Slot[SLAB_NODES]);
+                ++poolSlabAllocations;
+            }
+            mem = slabs[slabIndex][used++].bytes;
+        }
+        return new (mem) Node(std::forward<Args>(args)...);
+    }
+    void destroy(Node *n)
+    {
+        n->~Node();
+        *reinterpret_cast<void **>(n) = freeList;
+        freeList = n;
+    }
+    // drops every node in one go; callers destroy non-trivial nodes first
+    void reset()
+    {
+        slabIndex = 0;
+        used = 0;
+        freeList = nullptr;
+    }
+    int slabCount() const { return static_cast<int>(slabs.size()); }
+    size_t bytes() const { return slabs.size() * SLAB_NODES * sizeof(Slot); }
+};
+
+// ---------- Data structures ---------- //
+
+// PlayerMove for replay
+struct PlayerMove
+{
+    int x, y;
+    float t;
+    PlayerMove(int X = 0, int Y = 0, float T = 0) : x(X), y(Y), t(T) {}
+};
+
+// LinkedList to store player path
+class LinkedListNode
+{
+public:
+    PlayerMove data;
+    LinkedListNode *next;
+    LinkedListNode(const PlayerMove &d) : data(d), next(nullptr) {}
+};
+class LinkedList
+{
+    LinkedListNode *head = nullptr;
+    LinkedListNode *tail = nullptr;
+    int sz = 0;
+    NodePool<LinkedListNode> pool;
+
+public:
+    void add(const PlayerMove &m)
+    {
+        LinkedListNode *n = pool.create(m);
+        if (!head)
+            head = tail = n;
+        else
+        {
+            tail->next = n;
+            tail = n;
+        }
+        ++sz;
+    }
+    LinkedListNode *getHead() { return head; }
+    int getSize() const { return sz; }
+    void clear()
+    {
+        // moves are trivially destructible, so the whole list goes at once
+        pool.reset();
+        head = tail = nullptr;
+        sz = 0;
+    }
+};
+
+template <typename T>
+class Stack
+{
+    struct Node
+    {
+        T data;
+        Node *next;
+        Node(const T &d, Node *n = nullptr) : data(d), next(n) {}
+    };
+    Node *head;
+    NodePool<Node> pool;
+
+public:
+    Stack() : head(nullptr) {}
+    ~Stack() { clear(); }
+
+    bool empty() const { return head == nullptr; }
+
+    void push(const T &value)
+    {
+        head = pool.create(value, head);
+    }
+
+    T &top()
+    {
+        return head->data;
+    }
+
+    void pop()
+    {
+        if (!head)
+            return;
+        Node *tmp = head;
+        head = head->next;
+        pool.destroy(tmp);
+    }
+
+    void clear()
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            while (head)
+                pop();
+        head = nullptr;
+        pool.reset();
+    }
+};
+
+template <typename T>
+class Queue
+{
+    struct Node
+    {
+        T data;
+        Node *next;
+        Node(const T &d) : data(d), next(nullptr) {}
+    };
+    Node *frontNode;
+    Node *backNode;
+    NodePool<Node> pool;
+
+public:
+    Queue() : frontNode(nullptr), backNode(nullptr) {}
+    ~Queue() { clear(); }
+
+    bool empty() const { return frontNode == nullptr; }
+
+    void push(const T &value)
+    {
+        Node *n = pool.create(value);
+        if (!backNode)
+        {
+            frontNode = backNode = n;
+        }
+        else
+        {
+            backNode->next = n;
+            backNode = n;
+        }
+    }
+
+    T &front()
+    {
+        return frontNode->data;
+    }
+
+    void pop()
+    {
+        if (!frontNode)
+            return;
+        Node *tmp = frontNode;
+        frontNode = frontNode->next;
+        if (!frontNode)
+            backNode = nullptr;
+        pool.destroy(tmp);
+    }
+
+    void clear()
+    {
+        if (!std::is_trivially_destructible<T>::value)
+            while (frontNode)
+                pop();
+        frontNode = backNode = nullptr;
+        pool.reset();
+    }
+    // slabs held by the queue, which stay allocated across clear()
+    size_t poolBytes() const { return pool.bytes(); }
+};
+
+// Maze difficulty data container
+struct MazeDifficulty
+{
+    int id;
+    float score;
+    int rows, cols;
+    unsigned long long seed; // regenerates cellBytes (see CandidateSearchParams)
+    int attempts;            // mazes generated to get this one
+    std::vector<unsigned char> cellBytes;
+    MazeDifficulty() : id(0), score(0), rows(0), cols(0), seed(0), attempts(0) {}
+    MazeDifficulty(int id_, float sc, int r, int c) : id(id_), score(sc), rows(r), cols(c), seed(0), attempts(1), cellBytes(r * c, 0) {}
+    bool operator<(MazeDifficulty const &o) const { return score < o.score; }
+};
+
+// Scoreboard
+struct PlayerScore
+{
+    std::string name;
+    float time;
+    DifficultyLevel diff;
+    std::string date;
+    PlayerScore() : name(""), time(0), diff(DIFF_EASY), date("") {}
+    PlayerScore(std::string n, float t, DifficultyLevel d, std::string dt) : name(n), time(t), diff(d), date(dt) {}
+    bool operator<(PlayerScore const &o) const { return time < o.time; }
+};
+class BSTNode
+{
+public:
+    PlayerScore data;
+    BSTNode *left = nullptr;
+    BSTNode *right = nullptr;
+    BSTNode(const PlayerScore &p) : data(p) {}
+};
+class ScoreBST
+{
+    BSTNode *root = nullptr;
+    BSTNode *insert(BSTNode *node, const PlayerScore &p)
+    {
+        if (!node)
+            return new BSTNode(p);
+        if (p < node->data)
+            node->left = insert(node->left, p);
+        else
+            node->right = insert(node->right, p);
+        return node;
+    }
+    void inorder(BSTNode *n, std::vector<PlayerScore> &out)
+    {
+        if (!n)
+            return;
+        inorder(n->left, out);
+        out.push_back(n->data);
+        inorder(n->right, out);
+    }
+    void destroy(BSTNode *n)
+    {
+        if (!n)
+            return;
+        destroy(n->left);
+        destroy(n->right);
+        delete n;
+    }
+
+public:
+    ~ScoreBST() { clear(); }
+    void add(const PlayerScore &p) { root = insert(root, p); }
+    std::vector<PlayerScore> getSorted()
+    {
+        std::vector<PlayerScore> out;
+        inorder(root, out);
+        return out;
+    }
+    void clear()
+    {
+        destroy(root);
+        root = nullptr;
+    }
+};
+
+// ---------- Visited set (dense bitset) ---------- //
+// One bit per cell, indexed the same way as MazeGrid (y * cols + x).
+class VisitBitset
+{
+    int cols = 0;
+    std::vector<unsigned long long> words;
+
+public:
+    void reset(int rows, int c)
+    {
+        cols = c;
+        words.assign((static_cast<size_t>(rows) * c + 63) / 64, 0);
+    }
+    void clear() { words.assign(words.size(), 0); }
+    void mark(int i) { words[i >> 6] |= 1ULL << (i & 63); }
+    void mark(int x, int y) { mark(y * cols + x); }
+    bool isVisited(int i) const { return (words[i >> 6] >> (i & 63)) & 1ULL; }
+    bool isVisited(int x, int y) const { return isVisited(y * cols + x); }
+};
+
+// ---------- Maze grid (packed, one byte per cell) ---------- //
+// bits 0-3: walls up/down/left/right, bit 4: carved path, bit 5: replay highlight
+enum Direction
+{
+    DIR_UP,
+    DIR_DOWN,
+    DIR_LEFT,
+    DIR_RIGHT
+};
+const int DIR_DX[4] = {0, 0, -1, 1};
+const int DIR_DY[4] = {-1, 1, 0, 0};
+inline int OppositeDir(int d) { return d ^ 1; }
+
+const unsigned char WALL_MASK = 0x0F;
+const unsigned char CELL_PATH = 1 << 4;
+// number of open sides for every 4-bit wall mask
+const int OPEN_SIDES[16] = {4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0};
+
+// Dead-end and branch counts kept up to date while a generator carves, so
+// the difficulty score needs no second pass over the grid.
+struct MazeMetrics
+{
+    int deadEnds = 0, branches = 0;
+    // a cell with open open sides just got one more
+    void opened(int open)
+    {
+        deadEnds += (open == 0) - (open == 1);
+        branches += open == 2;
+    }
+};
+
+// Cells of a packed grid bucketed by open sides: 1 (dead end), 2
+// (corridor) and 3-4 (junction).
+struct MazeShapeCounts
+{
+    long long deadEnds = 0, corridors = 0, junctions = 0;
+};
+// Counts n packed cells (only the wall nibble is read). countShape uses the
+// widest kernel this build targets: AVX2 (32 cells per step), SSE2 (16), or
+// the scalar lookup, which stays available as a reference.
+MazeShapeCounts countShape(const unsigned char *cells, size_t n);
+MazeShapeCounts countShapeScalar(const unsigned char *cells, size_t n);
+const char *shapeKernelName();
+
+// Wall state is versioned so solvers can cache derived data: every grid
+// (and every copy) gets a process-wide id on a fresh start, and each wall
+// edit after that bumps a plain counter. The same (id, edits) pair means the
+// same walls.
+class MazeGrid
+{
+    int rows = 0, cols = 0;
+    std::vector<unsigned char> cells;
+    unsigned long long gridId = freshId();
+    unsigned long long edits = 0;
+
+    static unsigned long long freshId()
+    {
+        static std::atomic<unsigned long long> next(1);
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+    void restart()
+    {
+        gridId = freshId();
+        edits = 0;
+    }
+
+public:
+    MazeGrid() {}
+    MazeGrid(const MazeGrid &o) : rows(o.rows), cols(o.cols), cells(o.cells) {}
+    MazeGrid &operator=(const MazeGrid &o)
+    {
+        rows = o.rows;
+        cols = o.cols;
+        cells = o.cells;
+        restart();
+        return *this;
+    }
+    MazeGrid(MazeGrid &&o) noexcept : rows(o.rows), cols(o.cols), cells(std::move(o.cells)) { o.clear(); }
+    MazeGrid &operator=(MazeGrid &&o) noexcept
+    {
+        rows = o.rows;
+        cols = o.cols;
+        cells = std::move(o.cells);
+        restart();
+        o.clear();
+        return *this;
+    }
+
+    void reset(int r, int c)
+    {
+        rows = r;
+        cols = c;
+        cells.assign(static_cast<size_t>(r) * c, WALL_MASK);
+        restart();
+    }
+    void assign(int r, int c, const std::vector<unsigned char> &bytes)
+    {
+        rows = r;
+        cols = c;
+        cells = bytes;
+        restart();
+    }
+    void clear()
+    {
+        rows = cols = 0;
+        cells.clear();
+        restart();
+    }
+    unsigned long long id() const { return gridId; }
+    unsigned long long editCount() const { return edits; }
+    bool empty() const { return cells.empty(); }
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    int size() const { return rows * cols; }
+    const std::vector<unsigned char> &bytes() const { return cells; }
+    // raw row access for bulk writes; counts as an edit
+    unsigned char *rowData(int y)
+    {
+        ++edits;
+        return &cells[static_cast<size_t>(y) * cols];
+    }
+
+    int index(int x, int y) const { return y * cols + x; }
+    int xOf(int i) const { return i % cols; }
+    int yOf(int i) const { return i / cols; }
+    bool inBounds(int x, int y) const { return x >= 0 && x < cols && y >= 0 && y < rows; }
+
+    unsigned char wallMask(int i) const { return cells[i] & WALL_MASK; }
+    int openSides(int i) const { return OPEN_SIDES[cells[i] & WALL_MASK]; }
+    bool hasWall(int i, int d) const { return (cells[i] & (1 << d)) != 0; }
+    bool hasWall(int x, int y, int d) const { return hasWall(index(x, y), d); }
+    // removes wall d of cell i only (for openings on the grid border)
+    void clearWall(int i, int d)
+    {
+        cells[i] &= ~(1 << d);
+        ++edits;
+    }
+    // removes wall d of cell i and the matching wall of its neighbour
+    void carve(int i, int d)
+    {
+        cells[i] &= ~(1 << d);
+        cells[i + DIR_DY[d] * cols + DIR_DX[d]] &= ~(1 << OppositeDir(d));
+        ++edits;
+    }
+    // puts back wall d of cell i and the matching wall of its neighbour
+    void raiseWall(int i, int d)
+    {
+        cells[i] |= 1 << d;
+        cells[i + DIR_DY[d] * cols + DIR_DX[d]] |= 1 << OppositeDir(d);
+        ++edits;
+    }
+    void carve(int i, int d, MazeMetrics &m)
+    {
+        m.opened(openSides(i));
+        m.opened(openSides(i + DIR_DY[d] * cols + DIR_DX[d]));
+        carve(i, d);
+    }
+
+    bool isPath(int i) const { return (cells[i] & CELL_PATH) != 0; }
+    bool isPath(int x, int y) const { return isPath(index(x, y)); }
+    void setPath(int i) { cells[i] |= CELL_PATH; }
+};
+struct Coord
+{
+    int x, y;
+};
+
+// Cells lit by a replay, kept apart from the grid: the last few steps in a
+// ring buffer, where each new step overwrites the oldest. A step is O(1)
+// and clearing is O(1), however large the maze is.
+class ReplayOverlay
+{
+    std::vector<Coord> ring;
+    int next = 0, count = 0; // next slot to write, steps held
+
+public:
+    explicit ReplayOverlay(int trailLength = 1) { setTrailLength(trailLength); }
+
+    void setTrailLength(int n)
+    {
+        ring.assign(n > 0 ? n : 1, Coord{0, 0});
+        next = count = 0;
+    }
+    int trailLength() const { return static_cast<int>(ring.size()); }
+    void clear() { next = count = 0; }
+    void step(Coord c)
+    {
+        ring[next] = c;
+        next = (next + 1) % trailLength();
+        if (count < trailLength())
+            ++count;
+    }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    // age 0 is the newest cell, size() - 1 the oldest still lit
+    const Coord &recent(int age) const { return ring[(next - 1 - age + 2 * trailLength()) % trailLength()]; }
+};
+
+// ---------- Generation / solving / scoring ---------- //
+enum MazeAlgorithm
+{
+    ALGO_BACKTRACKER, // iterative randomized DFS, long winding corridors
+    ALGO_ELLER        // Eller's algorithm, row by row in O(cols) memory
+};
+
+// Every generator takes a 64-bit seed and runs its own MazeRng stream, so
+// the same (seed, rows, cols, algorithm) always gives the same maze and
+// concurrent calls never share RNG state. When metrics is not null it
+// receives the maze's shape counts, for difficultyScore().
+
+// Carves a perfect maze into grid with an iterative randomized DFS.
+void generateFullMaze(MazeGrid &grid, int rows, int cols, unsigned long long seed, MazeMetrics *metrics = nullptr);
+
+// Receives every finished row of an Eller's maze: y and cols cell bytes in
+// MazeGrid layout. The buffer is reused for the next row.
+typedef std::function<void(int y, const unsigned char *row, int cols)> MazeRowSink;
+// Streams a perfect maze to sink one row at a time; only the current row's
+// set state is kept, so rows can go into the millions.
+void generateEllerRows(int rows, int cols, unsigned long long seed, const MazeRowSink &sink, MazeMetrics *metrics = nullptr);
+// Eller's algorithm collected into a full grid.
+void generateEllerMaze(MazeGrid &grid, int rows, int cols, unsigned long long seed, MazeMetrics *metrics = nullptr);
+// Growing-tree generator: each step extends the newest active cell with
+// probability newestBias, otherwise a random one. 1 gives DFS-like long
+// corridors, 0 gives Prim-like mazes with many short dead ends.
+void generateGrowingTree(MazeGrid &grid, int rows, int cols, unsigned long long seed, float newestBias, MazeMetrics *metrics = nullptr);
+// Dispatches to the generator for algo.
+void generateMaze(MazeGrid &grid, int rows, int cols, unsigned long long seed, MazeAlgorithm algo, MazeMetrics *metrics = nullptr);
+// 64-bit FNV-1a of the wall bits, for checking that a seed reproduces a maze.
+unsigned long long mazeDigest(const MazeGrid &grid);
+// Seeds are written and read as 16 hex digits; parseSeed accepts 1-16.
+std::string formatSeed(unsigned long long seed);
+bool parseSeed(const std::string &text, unsigned long long &seed);
+// True when every cell is reachable from (0,0) and there are no loops.
+bool isPerfectMaze(const MazeGrid &grid);
+// Shortest path from (0,0) to the bottom-right cell, empty if unreachable.
+// Runs a per-thread BfsSolver; maze-solvers.h has the other solvers.
+std::vector<Coord> BFSSolve(const MazeGrid &grid);
+// 0..100 score from dead ends, branches and grid extent, scaled so that
+// DFS mazes score ~10 and Prim-like ones ~95.
+float evaluateDifficulty(const MazeGrid &grid);
+// The same score from counts a generator kept; bit-identical to
+// evaluateDifficulty on the finished maze.
+float difficultyScore(int rows, int cols, const MazeMetrics &metrics);
+// Score range a maze must fall into to count as the given difficulty.
+void difficultyBand(DifficultyLevel level, float &minScore, float &maxScore);
+
+// What one generateForDifficulty call cost and where it ended up.
+struct TargetReport
+{
+    int attempts = 0;
+    double ms = 0;
+    float score = 0;
+    float bias = 0;
+    bool inBand = false;
+};
+// Steers the growing-tree bias toward [minScore, maxScore]: the first
+// attempt uses a calibrated bias for the band centre, later ones bisect on
+// it (attempt k uses deriveSeed(seed, k)). Returns false if no attempt
+// landed in the band, leaving the closest one in grid.
+bool generateForDifficulty(MazeGrid &grid, int rows, int cols, unsigned long long seed, float minScore, float maxScore,
+                           TargetReport *report = nullptr);
+
+// ---------- Score file I/O ---------- //
+void SaveScoreToFile(const PlayerScore &p, const std::string &path = "scores.txt");
+void LoadScoresFromFile(ScoreBST &easy, ScoreBST &medium, ScoreBST &hard, const std::string &path = "scores.txt");
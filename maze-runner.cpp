@@ -1,6 +1,15 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include "raylib.h"
+#include "maze-core.h"
+#include "candidate-search.h"
+#include "chunked-maze.h"
+#include "maze-solvers.h"
+#include "dynamic-maze.h"
+#include "wall-mesh.h"
+#include "frame-profiler.h"
+#include "trace-events.h"
+#include "rlgl.h"
 #include <vector>
 #include <ctime>
 #include <cstdlib>
@@ -11,21 +20,33 @@
 #include <cmath>
 #include <iomanip>
 #include <sstream>
-#include <random>
 #include <chrono>
+#include <cctype>
 using namespace std;
 
 // ---------- Constants & Enums ---------- //
 const int SCREEN_WIDTH = 1000;
 const int SCREEN_HEIGHT = 700;
 const int FPS = 60;
+const int SIM_HZ = 240;               // fixed simulation rate, independent of the frame rate
+const float SIM_DT = 1.0f / SIM_HZ;
+const int REPLAY_STEP_TICKS = 30;     // one replay step every 0.125 s
+const int MOVE_SLIDE_TICKS = 16;      // the player icon slides between cells over this many ticks
 const int UI_PANEL_WIDTH = 300;
+const float ENDLESS_CELL_SIZE = 28.0f;
+const int ENDLESS_WINDOW_RADIUS = 24; // cells kept loaded around the player
+const float READABLE_CELL_SIZE = 16.0f; // default cell size when the whole maze would be smaller
+const float MIN_CELL_SIZE = 8.0f;       // furthest zoom-out on mazes that do not fit
+const float MAX_CELL_SIZE = 64.0f;      // closest zoom-in
+const int REPLAY_TRAIL_LENGTH = 12;     // cells that stay lit behind a replay, fading out
+const int SHIFTING_WALLS_MAX_CELLS = 200 * 200; // D* Lite keeps up at 60 FPS up to this size
 
 enum MazeSize
 {
     SIZE_SMALL = 20,
     SIZE_MEDIUM = 30,
-    SIZE_LARGE = 40
+    SIZE_LARGE = 40,
+    SIZE_HUGE = 2000
 };
 enum GameState
 {
@@ -37,13 +58,8 @@ enum GameState
     STATE_PLAYING,
     STATE_END,
     STATE_SCOREBOARD,
-    STATE_REPLAY
-};
-enum DifficultyLevel
-{
-    DIFF_EASY,
-    DIFF_MEDIUM,
-    DIFF_HARD
+    STATE_REPLAY,
+    STATE_SEED_ENTRY
 };
 
 // ---------- Colors (custom) ---------- //
@@ -56,327 +72,14 @@ const Color GREENDARK = Color{0, 100, 0, 255};
 const Color BLUEDARK = Color{0, 0, 139, 255};
 const Color UI_BLUE = Color{52, 110, 255, 255};
 
-// ---------- RNG ---------- //
-static std::mt19937 rng((unsigned)chrono::system_clock::now().time_since_epoch().count());
-int irand(int a, int b) { return std::uniform_int_distribution<int>(a, b)(rng); }
+// ---------- Seeds ---------- //
+// Only hands out fresh maze seeds; every maze is built from its own seed, so
+// the one shown in the HUD can be typed back in to play the same maze again.
+static MazeRng seedSource(mixSeed(static_cast<unsigned long long>(chrono::system_clock::now().time_since_epoch().count())));
 
 // --------- Music ------------- //
 Music backgroundMusic;
 
-// ---------- Data structures ---------- //
-
-// PlayerMove for replay
-struct PlayerMove
-{
-    int x, y;
-    float t;
-    PlayerMove(int X = 0, int Y = 0, float T = 0) : x(X), y(Y), t(T) {}
-};
-
-// LinkedList to store player path
-class LinkedListNode
-{
-public:
-    PlayerMove data;
-    LinkedListNode *next;
-    LinkedListNode(const PlayerMove &d) : data(d), next(nullptr) {}
-};
-class LinkedList
-{
-    LinkedListNode *head = nullptr;
-    LinkedListNode *tail = nullptr;
-    int sz = 0;
-
-public:
-    ~LinkedList() { clear(); }
-    void add(const PlayerMove &m)
-    {
-        LinkedListNode *n = new LinkedListNode(m);
-        if (!head)
-            head = tail = n;
-        else
-        {
-            tail->next = n;
-            tail = n;
-        }
-        ++sz;
-    }
-    LinkedListNode *getHead() { return head; }
-    int getSize() const { return sz; }
-    void clear()
-    {
-        LinkedListNode *p = head;
-        while (p)
-        {
-            LinkedListNode *t = p;
-            p = p->next;
-            delete t;
-        }
-        head = tail = nullptr;
-        sz = 0;
-    }
-};
-
-template <typename T>
-class Stack
-{
-    struct Node
-    {
-        T data;
-        Node *next;
-        Node(const T &d, Node *n = nullptr) : data(d), next(n) {}
-    };
-    Node *head;
-
-public:
-    Stack() : head(nullptr) {}
-    ~Stack() { clear(); }
-
-    bool empty() const { return head == nullptr; }
-
-    void push(const T &value)
-    {
-        head = new Node(value, head);
-    }
-
-    T &top()
-    {
-        return head->data;
-    }
-
-    void pop()
-    {
-        if (!head)
-            return;
-        Node *tmp = head;
-        head = head->next;
-        delete tmp;
-    }
-
-    void clear()
-    {
-        while (head)
-        {
-            Node *tmp = head;
-            head = head->next;
-            delete tmp;
-        }
-    }
-};
-
-template <typename T>
-class Queue
-{
-    struct Node
-    {
-        T data;
-        Node *next;
-        Node(const T &d) : data(d), next(nullptr) {}
-    };
-    Node *frontNode;
-    Node *backNode;
-
-public:
-    Queue() : frontNode(nullptr), backNode(nullptr) {}
-    ~Queue() { clear(); }
-
-    bool empty() const { return frontNode == nullptr; }
-
-    void push(const T &value)
-    {
-        Node *n = new Node(value);
-        if (!backNode)
-        {
-            frontNode = backNode = n;
-        }
-        else
-        {
-            backNode->next = n;
-            backNode = n;
-        }
-    }
-
-    T &front()
-    {
-        return frontNode->data;
-    }
-
-    void pop()
-    {
-        if (!frontNode)
-            return;
-        Node *tmp = frontNode;
-        frontNode = frontNode->next;
-        if (!frontNode)
-            backNode = nullptr;
-        delete tmp;
-    }
-
-    void clear()
-    {
-        while (frontNode)
-        {
-            Node *tmp = frontNode;
-            frontNode = frontNode->next;
-            delete tmp;
-        }
-        backNode = nullptr;
-    }
-};
-
-// Maze difficulty data container
-struct MazeDifficulty
-{
-    int id;
-    float score;
-    int rows, cols;
-    vector<unsigned char> cellBytes;
-    MazeDifficulty() : id(0), score(0), rows(0), cols(0) {}
-    MazeDifficulty(int id_, float sc, int r, int c) : id(id_), score(sc), rows(r), cols(c), cellBytes(r * c, 0) {}
-    bool operator<(MazeDifficulty const &o) const { return score < o.score; }
-};
-
-// Scoreboard
-struct PlayerScore
-{
-    string name;
-    float time;
-    DifficultyLevel diff;
-    string date;
-    PlayerScore() : name(""), time(0), diff(DIFF_EASY), date("") {}
-    PlayerScore(string n, float t, DifficultyLevel d, string dt) : name(n), time(t), diff(d), date(dt) {}
-    bool operator<(PlayerScore const &o) const { return time < o.time; }
-};
-class BSTNode
-{
-public:
-    PlayerScore data;
-    BSTNode *left = nullptr;
-    BSTNode *right = nullptr;
-    BSTNode(const PlayerScore &p) : data(p) {}
-};
-class ScoreBST
-{
-    BSTNode *root = nullptr;
-    BSTNode *insert(BSTNode *node, const PlayerScore &p)
-    {
-        if (!node)
-            return new BSTNode(p);
-        if (p < node->data)
-            node->left = insert(node->left, p);
-        else
-            node->right = insert(node->right, p);
-        return node;
-    }
-    void inorder(BSTNode *n, vector<PlayerScore> &out)
-    {
-        if (!n)
-            return;
-        inorder(n->left, out);
-        out.push_back(n->data);
-        inorder(n->right, out);
-    }
-    void destroy(BSTNode *n)
-    {
-        if (!n)
-            return;
-        destroy(n->left);
-        destroy(n->right);
-        delete n;
-    }
-
-public:
-    ~ScoreBST() { clear(); }
-    void add(const PlayerScore &p) { root = insert(root, p); }
-    vector<PlayerScore> getSorted()
-    {
-        vector<PlayerScore> out;
-        inorder(root, out);
-        return out;
-    }
-    void clear()
-    {
-        destroy(root);
-        root = nullptr;
-    }
-};
-
-// ---------- Visit table ---------- //
-class VisitHashTable
-{
-    static const int SIZE = 1031;
-    struct Node
-    {
-        int x, y;
-        Node *next;
-        Node(int X, int Y) : x(X), y(Y), next(nullptr) {}
-    };
-    vector<Node *> table;
-    int h(int x, int y) const
-    {
-        unsigned long long v = ((unsigned long long)(unsigned)x << 32) ^ (unsigned)y;
-        return static_cast<int>(v % SIZE);
-    }
-
-public:
-    VisitHashTable() : table(SIZE, nullptr) {}
-    ~VisitHashTable() { clear(); }
-    void mark(int x, int y)
-    {
-        int idx = h(x, y);
-        Node *n = new Node(x, y);
-        n->next = table[idx];
-        table[idx] = n;
-    }
-    bool isVisited(int x, int y) const
-    {
-        int idx = h(x, y);
-        Node *p = table[idx];
-        while (p)
-        {
-            if (p->x == x && p->y == y)
-                return true;
-            p = p->next;
-        }
-        return false;
-    }
-    void clear()
-    {
-        for (int i = 0; i < SIZE; ++i)
-        {
-            Node *p = table[i];
-            while (p)
-            {
-                Node *t = p;
-                p = p->next;
-                delete t;
-            }
-            table[i] = nullptr;
-        }
-    }
-};
-
-// ---------- Cell ---------- //
-struct Cell
-{
-    int x = 0, y = 0;
-    bool walls[4];
-    bool isPath;
-    bool isReplay;
-    Cell() : x(0), y(0), isPath(false), isReplay(false)
-    {
-        walls[0] = walls[1] = walls[2] = walls[3] = true;
-    }
-    Cell(int X, int Y) : x(X), y(Y), isPath(false), isReplay(false)
-    {
-        walls[0] = walls[1] = walls[2] = walls[3] = true;
-    }
-};
-struct Coord
-{
-    int x, y;
-};
-
 // ---------- Button ---------- //
 struct Button
 {
@@ -412,29 +115,112 @@ GameState currentState = STATE_HOME;
 DifficultyLevel currentDifficulty = DIFF_EASY;
 int mazeRows = SIZE_SMALL, mazeCols = SIZE_SMALL;
 float cellSize = 0.0f;
-vector<vector<Cell>> maze;
-Stack<Cell *> dfsStack;
-VisitHashTable visitedTable;
+float mazeZoom = 1.0f; // wheel or +/- during play; 1 is the default cell size
+MazeGrid maze;
 LinkedList playerPath;
 string playerInput = "";
 bool nameEntered = false;
-vector<Coord> solutionPath;
+vector<Coord> solutionPath;        // filled when the optimal path is first shown
+unique_ptr<MazeSolver> mazeSolver; // --solver bfs|bidi|astar|bitbfs|parallel|junction, BFS by default
+DistanceField goalDistance;       // built once per maze, read every frame
+bool showHint = false;            // H toggles the arrow toward the cheese
+bool shiftingWallsMode = false;   // toggled on the size screen
+ShiftingWalls mazeTraps;          // placed per maze, restored when play ends
+DStarLite liveSolver;             // path from the player, repaired as walls move
+vector<Coord> livePath;
+vector<int> movedTraps;
 int playerX = 0, playerY = 0, movesCount = 0;
 float gameTimer = 0.0f, countdownTimer = 3.0f;
+long long gameTicks = 0; // gameTimer is always gameTicks / SIM_HZ
 bool gamePaused = false, musicEnabled = true, musicPlaying = false;
 ;
 vector<MazeDifficulty> generatedMazes;
+int mazeCandidateCount = 1;
+MazeAlgorithm mazeAlgorithm = ALGO_BACKTRACKER;
+bool mazeTargeted = true; // false once --algo picks a fixed generator
+CandidateSearchReport lastMazeReport;
+unique_ptr<WorkerPool> workerPool;
+CandidateSearch mazeSearch;
+// A maze being made ready on the worker pool: generated from a seed or
+// code, or unpacked from a picked search candidate, plus its distance field.
+struct MazeLoad
+{
+    int rows = 0, cols = 0;
+    unsigned long long seed = 0;
+    bool targeted = false;
+    DifficultyLevel level = DIFF_EASY; // targeted only
+    MazeAlgorithm algorithm = ALGO_BACKTRACKER;
+    bool fromSearch = false;           // cellBytes and score come from the candidate search
+    std::vector<unsigned char> cellBytes;
+    MazeGrid grid;
+    DistanceField field;
+    float score = 0.0f;
+    TargetReport report;
+    atomic<bool> done{false}; // the worker is finished with everything above
+};
+shared_ptr<MazeLoad> mazeLoad; // null when no load is pending
+bool endlessMode = false;
+ChunkedMaze endlessMaze;
+int endlessFurthest = 0;
 float currentMazeScore = 0.0f;
+unsigned long long currentMazeSeed = 0;
+bool currentMazeTargeted = false;
+string seedInput = "";
 ScoreBST easyScores, mediumScores, hardScores;
 string playerName = "Player";
-vector<Button> homeButtons, sizeButtons, diffButtons, endButtons, mainButtons;
+vector<Button> homeButtons, sizeButtons, diffButtons, endButtons, compareButtons, mainButtons;
 Button musicBtn, pauseBtn;
 bool endButtonsCreated = false;
 bool mainButtonsCreated = false;
 bool gameCompleted = false;
+
+// ---------- Run analysis ---------- //
+// What the end screen reports about a finished run. Worked out once when
+// the cheese is reached; the end screen only draws it.
+struct RunAnalysis
+{
+    bool valid = false;
+    bool perfect = false;
+    int moves = 0, optimalMoves = 0, extraMoves = 0; // with shifting walls, as the walls stood at each move
+    int firstDivergence = -1; // first move that did not close in on the cheese, -1 if none
+    int backtracks = 0;       // moves straight back to the cell before
+    float deadEndTime = 0.0f; // seconds spent on moves off the shortest path
+};
+RunAnalysis runAnalysis;
+vector<unsigned char> onShortestPath; // reused between runs
+// With shifting walls the static distance field is wrong (an open trap is a
+// shortcut), so each move records the live distance to the cheese just
+// before and just after it, both under the walls of that moment.
+struct LiveStep
+{
+    int before, after;
+};
+vector<LiveStep> liveSteps;
+bool liveRun = false; // this run had shifting walls; liveSteps holds its moves
 vector<Coord> replayPath;
+ReplayOverlay replayTrail(REPLAY_TRAIL_LENGTH);
+
+// ---------- Frame profiler ---------- //
+// F3 shows per-phase timings; every frame is also written to
+// frame-profile.csv on exit. Build with -DMAZE_NO_PROFILER to drop it.
+#ifndef MAZE_NO_PROFILER
+enum ProfilePhase
+{
+    PHASE_HOVERS,
+    PHASE_MUSIC,
+    PHASE_UPDATE,
+    PHASE_DRAW, // everything between BeginDrawing and EndDrawing, including the phases below
+    PHASE_MAZE,
+    PHASE_DECORATIONS,
+    PHASE_PLAYER,
+    PHASE_HUD,
+    PHASE_PRESENT // EndDrawing: buffer swap and the wait for the target FPS
+};
+FrameProfiler frameProfiler({"hovers", "music", "update", "draw", "maze", "decorations", "player", "hud", "present"});
+bool showProfiler = false;
+#endif
 int replayIndex = 0;
-float replayTimer = 0.0f;
+int replayTicks = 0;
 float replayDisplayTime = 0.0f;
 int replayDisplayMoves = 0;
 bool replayDisplayHasTime = false;
@@ -442,6 +228,26 @@ Color pathColor = Color{200, 200, 210, 220};
 Color playerColor = Color{255, 100, 0, 200};
 bool replaySessionIsSolution = false;
 
+// ---------- Fixed timestep ---------- //
+// Timers, traps and replays advance in SIM_HZ ticks; each frame runs every
+// tick real time has covered, however long the frame took, and draws in
+// between them. Keys are read once per frame and the moves land on the
+// first tick that follows.
+int targetFps = FPS;          // --fps N, 0 for uncapped
+double simAccumulator = 0.0;  // real time not yet simulated, under one tick
+long long simTick = 0;        // ticks since start, paused or not
+vector<int> pendingMoves;     // read this frame, applied on the next tick
+int prevPlayerX = 0, prevPlayerY = 0;
+long long playerMoveTick = -MOVE_SLIDE_TICKS;
+
+// the player's drawn cell: part way from the previous cell while sliding
+Vector2 PlayerDrawCell()
+{
+    float t = (simTick - playerMoveTick + static_cast<float>(simAccumulator / SIM_DT)) / MOVE_SLIDE_TICKS;
+    t = min(1.0f, max(0.0f, t));
+    return {prevPlayerX + (playerX - prevPlayerX) * t, prevPlayerY + (playerY - prevPlayerY) * t};
+}
+
 // ---------- Utilities ---------- //
 string CurrentDateTime()
 {
@@ -471,184 +277,6 @@ void DrawCenteredTextShadow(const char *text, int centerX, int y, int fontSize,
     DrawTextShadow(text, centerX - tw / 2, y, fontSize, color);
 }
 
-// ---------- Maze generation (iterative DFS) ---------- //
-void initMazeGrid(int rows, int cols)
-{
-    maze.clear();
-    maze.resize(rows, vector<Cell>(cols));
-    for (int y = 0; y < rows; ++y)
-        for (int x = 0; x < cols; ++x)
-            maze[y][x] = Cell(x, y);
-    while (!dfsStack.empty())
-        dfsStack.pop();
-    visitedTable.clear();
-}
-
-void generateFullMaze(int rows, int cols)
-{
-    mazeRows = rows;
-    mazeCols = cols;
-    initMazeGrid(rows, cols);
-
-    Cell *start = &maze[0][0];
-    start->isPath = true;
-    visitedTable.mark(0, 0);
-    dfsStack.push(start);
-
-    const int dx[4] = {0, 0, -1, 1};
-    const int dy[4] = {-1, 1, 0, 0};
-    while (!dfsStack.empty())
-    {
-        Cell *cur = dfsStack.top();
-        vector<int> dirs;
-        for (int d = 0; d < 4; ++d)
-        {
-            int nx = cur->x + dx[d], ny = cur->y + dy[d];
-            if (nx >= 0 && nx < mazeCols && ny >= 0 && ny < mazeRows && !visitedTable.isVisited(nx, ny))
-                dirs.push_back(d);
-        }
-        if (!dirs.empty())
-        {
-            std::shuffle(dirs.begin(), dirs.end(), rng);
-            int d = dirs[0];
-            int nx = cur->x + dx[d], ny = cur->y + dy[d];
-            if (d == 0)
-            {
-                cur->walls[0] = false;
-                maze[ny][nx].walls[1] = false;
-            }
-            else if (d == 1)
-            {
-                cur->walls[1] = false;
-                maze[ny][nx].walls[0] = false;
-            }
-            else if (d == 2)
-            {
-                cur->walls[2] = false;
-                maze[ny][nx].walls[3] = false;
-            }
-            else
-            {
-                cur->walls[3] = false;
-                maze[ny][nx].walls[2] = false;
-            }
-            maze[ny][nx].isPath = true;
-            visitedTable.mark(nx, ny);
-            dfsStack.push(&maze[ny][nx]);
-        }
-        else
-        {
-            dfsStack.pop();
-        }
-    }
-    maze[0][0].isPath = true;
-    maze[rows - 1][cols - 1].isPath = true;
-}
-
-// ---------- BFS solver ---------- //
-vector<Cell *> BFSSolve()
-{
-    vector<Cell *> path;
-    if (mazeRows <= 0 || mazeCols <= 0)
-        return path;
-    vector<vector<bool>> vis(mazeRows, vector<bool>(mazeCols, false));
-    vector<vector<Cell *>> parent(mazeRows, vector<Cell *>(mazeCols, nullptr));
-    Queue<Cell *> q;
-    q.push(&maze[0][0]);
-    vis[0][0] = true;
-    while (!q.empty())
-    {
-        Cell *cur = q.front();
-        q.pop();
-        if (cur->x == mazeCols - 1 && cur->y == mazeRows - 1)
-            break;
-        if (!cur->walls[0] && cur->y > 0 && !vis[cur->y - 1][cur->x])
-        {
-            vis[cur->y - 1][cur->x] = true;
-            parent[cur->y - 1][cur->x] = cur;
-            q.push(&maze[cur->y - 1][cur->x]);
-        }
-        if (!cur->walls[1] && cur->y < mazeRows - 1 && !vis[cur->y + 1][cur->x])
-        {
-            vis[cur->y + 1][cur->x] = true;
-            parent[cur->y + 1][cur->x] = cur;
-            q.push(&maze[cur->y + 1][cur->x]);
-        }
-        if (!cur->walls[2] && cur->x > 0 && !vis[cur->y][cur->x - 1])
-        {
-            vis[cur->y][cur->x - 1] = true;
-            parent[cur->y][cur->x - 1] = cur;
-            q.push(&maze[cur->y][cur->x - 1]);
-        }
-        if (!cur->walls[3] && cur->x < mazeCols - 1 && !vis[cur->y][cur->x + 1])
-        {
-            vis[cur->y][cur->x + 1] = true;
-            parent[cur->y][cur->x + 1] = cur;
-            q.push(&maze[cur->y][cur->x + 1]);
-        }
-    }
-    Cell *cur = &maze[mazeRows - 1][mazeCols - 1];
-    if (!parent[cur->y][cur->x] && !(cur->x == 0 && cur->y == 0))
-        return path;
-    while (cur)
-    {
-        path.push_back(cur);
-        Cell *p = parent[cur->y][cur->x];
-        if (p == cur)
-            break;
-        cur = p;
-    }
-    reverse(path.begin(), path.end());
-    return path;
-}
-
-// ---------- Score file I/O ---------- //
-void SaveScoreToFile(const PlayerScore &p)
-{
-    ofstream f("scores.txt", ios::app);
-    if (!f.is_open())
-        return;
-    f << p.name << "," << p.time << "," << (int)p.diff << "," << p.date << "\n";
-    f.close();
-}
-void LoadScoresFromFile()
-{
-    ifstream f("scores.txt");
-    if (!f.is_open())
-        return;
-    string line;
-    while (getline(f, line))
-    {
-        stringstream ss(line);
-        string name, timeS, diffS, date;
-        if (!getline(ss, name, ','))
-            continue;
-        if (!getline(ss, timeS, ','))
-            continue;
-        if (!getline(ss, diffS, ','))
-            continue;
-        if (!getline(ss, date))
-            continue;
-        try
-        {
-            float t = stof(timeS);
-            int di = stoi(diffS);
-            PlayerScore ps(name, t, (DifficultyLevel)di, date);
-            if (ps.diff == DIFF_EASY)
-                easyScores.add(ps);
-            else if (ps.diff == DIFF_MEDIUM)
-                mediumScores.add(ps);
-            else
-                hardScores.add(ps);
-        }
-        catch (...)
-        {
-            continue;
-        }
-    }
-    f.close();
-}
-
 // ---------- UI Initialization ---------- //
 void InitUI()
 {
@@ -658,14 +286,18 @@ void InitUI()
     homeButtons.push_back(Button(350, 360, 300, 60, "EXIT", DARKRED, Color{160, 20, 20, 255}));
 
     sizeButtons.clear();
-    sizeButtons.push_back(Button(350, 200, 300, 60, "SMALL (20x20)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
-    sizeButtons.push_back(Button(350, 280, 300, 60, "MEDIUM (30x30)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
-    sizeButtons.push_back(Button(350, 360, 300, 60, "LARGE (40x40)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
+    sizeButtons.push_back(Button(350, 160, 300, 60, "SMALL (20x20)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
+    sizeButtons.push_back(Button(350, 230, 300, 60, "MEDIUM (30x30)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
+    sizeButtons.push_back(Button(350, 300, 300, 60, "LARGE (40x40)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
+    sizeButtons.push_back(Button(350, 370, 300, 60, "HUGE (2000x2000)", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
+    sizeButtons.push_back(Button(350, 440, 300, 60, "ENDLESS", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
+    sizeButtons.push_back(Button(350, 540, 300, 50, shiftingWallsMode ? "SHIFTING WALLS: ON" : "SHIFTING WALLS: OFF", Color{70, 50, 90, 255}, Color{100, 75, 130, 255}));
 
     diffButtons.clear();
     diffButtons.push_back(Button(350, 200, 300, 60, "EASY", Color{50, 180, 80, 255}, GREENDARK));
     diffButtons.push_back(Button(350, 280, 300, 60, "MEDIUM", MY_ORANGE, DARKORANGE));
     diffButtons.push_back(Button(350, 360, 300, 60, "HARD", DARKRED, Color{160, 20, 20, 255}));
+    diffButtons.push_back(Button(350, 440, 300, 60, "PLAY SEED", Color{90, 90, 90, 255}, Color{120, 120, 120, 255}));
 
     endButtons.clear();
     int cx = (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2;
@@ -673,11 +305,14 @@ void InitUI()
     endButtons.push_back(Button(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 220.0f, 300, 60, "RETRY MAZE", UI_BLUE, BLUEDARK));
     endButtons.push_back(Button(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 280.0f, 300, 60, "SELECT ANOTHER", Color{40, 200, 120, 255}, GREENDARK));
     endButtons.push_back(Button(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 340.0f, 300, 60, "RETURN HOME", DARKRED, Color{160, 20, 20, 255}));
+    compareButtons.clear();
+    compareButtons.push_back(Button(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 100.0f, 300, 60, "OPTIMAL PATH", Color{70, 130, 255, 255}, BLUEDARK));
+    compareButtons.push_back(Button(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 160.0f, 300, 60, "REPLAY MY PATH", Color{40, 200, 120, 255}, GREENDARK));
 
     musicBtn = Button(static_cast<float>(SCREEN_WIDTH - UI_PANEL_WIDTH) + 12.0f, 12.0f, 36, 36, "M", Color{220, 220, 220, 255}, Color{200, 200, 200, 255});
     pauseBtn = Button(static_cast<float>(SCREEN_WIDTH - 150), 12.0f, 36, 36, "||");
 
-    LoadScoresFromFile();
+    LoadScoresFromFile(easyScores, mediumScores, hardScores);
     endButtonsCreated = true;
 }
 
@@ -729,14 +364,75 @@ void DrawPlayerIcon(float cx, float cy, float r)
 }
 
 // ---------- Draw Maze in Mice-Maze look (walls as green strips) ---------- //
-void DrawMaze()
+// The floors and walls only change when a new maze is loaded, so they are
+// drawn once into mazeLayer and the texture is blitted every frame. Trap
+// walls, the replay highlight, the cheese and the player go on top.
+RenderTexture2D mazeLayer = {};
+bool mazeLayerDirty = true;
+int mazeLayerRows = 0, mazeLayerCols = 0;
+float mazeLayerCellSize = 0.0f;
+WallMesh wallMesh; // merged wall runs, rebuilt with the layer
+
+// the DrawGreenWall look: dark fill, light top (or left) strip, dark outline
+WallStyle GreenWallStyle()
+{
+    WallStyle s;
+    s.fill = {14, 160, 0, 255};
+    s.highlight = {100, 220, 100, 255};
+    s.outline = {20, 90, 10, 255};
+    return s;
+}
+
+// Sends the whole vertex buffer as quads, split only where raylib's render
+// batch would overflow.
+void DrawWallMesh(const WallMesh &mesh)
+{
+    const vector<WallVertex> &v = mesh.vertices();
+    const size_t chunk = 4096; // vertices, a multiple of 4
+    for (size_t begin = 0; begin < v.size(); begin += chunk)
+    {
+        size_t end = min(v.size(), begin + chunk);
+        rlCheckRenderBatchLimit(static_cast<int>(end - begin));
+        rlBegin(RL_QUADS);
+        for (size_t i = begin; i < end; ++i)
+        {
+            rlColor4ub(v[i].color.r, v[i].color.g, v[i].color.b, v[i].color.a);
+            rlVertex2f(v[i].x, v[i].y);
+        }
+        rlEnd();
+    }
+}
+
+// call whenever the maze's walls are replaced or traps are placed or removed
+void InvalidateMazeLayer() { mazeLayerDirty = true; }
+
+void BakeMazeLayer(float startX, float startY)
 {
-    if (mazeRows <= 0 || mazeCols <= 0)
-        return;
     int mazeWidth = SCREEN_WIDTH - UI_PANEL_WIDTH;
-    cellSize = min(static_cast<float>(mazeWidth) / mazeCols, static_cast<float>(SCREEN_HEIGHT) / mazeRows);
-    float startX = (mazeWidth - mazeCols * cellSize) / 2.0f;
-    float startY = (SCREEN_HEIGHT - mazeRows * cellSize) / 2.0f;
+    if (mazeLayer.id == 0 || mazeLayer.texture.width != mazeWidth || mazeLayer.texture.height != SCREEN_HEIGHT)
+    {
+        if (mazeLayer.id != 0)
+            UnloadRenderTexture(mazeLayer);
+        mazeLayer = LoadRenderTexture(mazeWidth, SCREEN_HEIGHT);
+    }
+
+    // trap walls move, so both of their sides are baked open and the closed
+    // one is drawn live
+    const MazeGrid *grid = &maze;
+    MazeGrid open;
+    if (!mazeTraps.empty())
+    {
+        open = maze;
+        for (int i = 0; i < mazeTraps.size(); ++i)
+        {
+            open.carve(mazeTraps[i].wallCell, mazeTraps[i].wallSide);
+            open.carve(mazeTraps[i].gapCell, mazeTraps[i].gapSide);
+        }
+        grid = &open;
+    }
+
+    BeginTextureMode(mazeLayer);
+    ClearBackground(BLANK);
 
     // background frame
     DrawRectangle(static_cast<int>(startX) - 2, static_cast<int>(startY) - 2, static_cast<int>(mazeCols * cellSize + 4.0f), static_cast<int>(mazeRows * cellSize + 4.0f), BLACK);
@@ -749,26 +445,10 @@ void DrawMaze()
             float cx = startX + x * cellSize;
             float cy = startY + y * cellSize;
             float pad = cellSize * 0.06f;
-            if (maze[y][x].isPath)
+            if (grid->isPath(x, y))
             {
-                float cx = startX + x * cellSize;
-                float cy = startY + y * cellSize;
-                float pad = cellSize * 0.06f;
-
-                if (maze[y][x].isReplay)
-                {
-                    DrawRectangle((int)(cx + pad), (int)(cy + pad),
-                                  (int)(cellSize - 2 * pad), (int)(cellSize - 2 * pad),
-                                  Color{255, 215, 0, 220}); // gold
-                    DrawRectangleLines((int)(cx + pad), (int)(cy + pad),
-                                       (int)(cellSize - 2 * pad), (int)(cellSize - 2 * pad),
-                                       Fade(BLACK, 0.25f));
-                }
-                else
-                {
-                    DrawFloorTile(cx + pad, cy + pad,
-                                  cellSize - 2 * pad, cellSize - 2 * pad);
-                }
+                DrawFloorTile(cx + pad, cy + pad,
+                              cellSize - 2 * pad, cellSize - 2 * pad);
             }
             else
             {
@@ -777,81 +457,433 @@ void DrawMaze()
         }
     }
 
-    // walls as green strips on edges
+    // walls as green strips, one quad set per straight run of wall
     float wallThickness = max(2.0f, cellSize * 0.16f);
-    for (int y = 0; y < mazeRows; ++y)
+    wallMesh.build(*grid);
+    wallMesh.layout(startX, startY, cellSize, wallThickness, GreenWallStyle());
+    DrawWallMesh(wallMesh);
+    EndTextureMode();
+
+    mazeLayerRows = mazeRows;
+    mazeLayerCols = mazeCols;
+    mazeLayerCellSize = cellSize;
+    mazeLayerDirty = false;
+}
+
+// ---------- Camera ---------- //
+// Where the finite maze sits on screen. Cell (x, y) has its top-left corner
+// at origin + (x, y) * cellSize, and only cells first..last touch the play
+// area, so every drawing loop is bounded by the screen, not by the maze.
+// A maze that fits is shown whole; a larger one scrolls with the player.
+struct MazeView
+{
+    float originX = 0.0f, originY = 0.0f;
+    int firstX = 0, firstY = 0, lastX = -1, lastY = -1;
+    bool whole = true; // every cell is on screen
+    bool contains(int x, int y) const { return x >= firstX && x <= lastX && y >= firstY && y <= lastY; }
+};
+MazeView mazeView;
+
+// one axis: centre the maze if it fits, otherwise follow focus without
+// scrolling past the edges
+static float ViewOrigin(int cells, float screen, int focus)
+{
+    float extent = cells * cellSize;
+    if (extent <= screen)
+        return (screen - extent) / 2.0f;
+    float origin = screen / 2.0f - (focus + 0.5f) * cellSize;
+    return min(0.0f, max(screen - extent, origin));
+}
+
+void UpdateMazeView()
+{
+    int mazeWidth = SCREEN_WIDTH - UI_PANEL_WIDTH;
+    float fit = min(static_cast<float>(mazeWidth) / mazeCols, static_cast<float>(SCREEN_HEIGHT) / mazeRows);
+    float base = max(fit, READABLE_CELL_SIZE);
+    float lowest = max(fit, MIN_CELL_SIZE);
+    cellSize = min(max(base * mazeZoom, lowest), max(base, MAX_CELL_SIZE));
+    mazeZoom = cellSize / base;
+
+    // the replay is followed instead of the player
+    int fx = playerX, fy = playerY;
+    if (currentState == STATE_REPLAY && !replayTrail.empty())
     {
-        for (int x = 0; x < mazeCols; ++x)
+        fx = replayTrail.recent(0).x;
+        fy = replayTrail.recent(0).y;
+    }
+    MazeView &v = mazeView;
+    v.originX = ViewOrigin(mazeCols, static_cast<float>(mazeWidth), fx);
+    v.originY = ViewOrigin(mazeRows, static_cast<float>(SCREEN_HEIGHT), fy);
+    v.firstX = max(0, static_cast<int>(floor(-v.originX / cellSize)));
+    v.firstY = max(0, static_cast<int>(floor(-v.originY / cellSize)));
+    v.lastX = min(mazeCols - 1, static_cast<int>(floor((mazeWidth - v.originX) / cellSize)));
+    v.lastY = min(mazeRows - 1, static_cast<int>(floor((SCREEN_HEIGHT - v.originY) / cellSize)));
+    v.whole = v.originX >= 0 && v.originY >= 0;
+}
+
+// wheel or +/- zoom around the default cell size; UpdateMazeView clamps it
+void HandleZoomInput()
+{
+    float steps = GetMouseWheelMove();
+    if (IsKeyPressed(KEY_EQUAL) || IsKeyPressed(KEY_KP_ADD))
+        steps += 1.0f;
+    if (IsKeyPressed(KEY_MINUS) || IsKeyPressed(KEY_KP_SUBTRACT))
+        steps -= 1.0f;
+    if (steps != 0.0f)
+        mazeZoom *= powf(1.25f, steps);
+}
+
+// Floors and walls of the visible cells only, drawn straight from the grid
+// every frame; used whenever the maze does not fit the play area.
+void DrawMazeWindow()
+{
+    const MazeView &v = mazeView;
+    float startX = v.originX, startY = v.originY;
+
+    // background frame behind the visible part
+    DrawRectangle(static_cast<int>(startX + v.firstX * cellSize) - 2, static_cast<int>(startY + v.firstY * cellSize) - 2,
+                  static_cast<int>((v.lastX - v.firstX + 1) * cellSize + 4.0f), static_cast<int>((v.lastY - v.firstY + 1) * cellSize + 4.0f), BLACK);
+
+    float pad = cellSize * 0.06f;
+    for (int y = v.firstY; y <= v.lastY; ++y)
+    {
+        for (int x = v.firstX; x <= v.lastX; ++x)
         {
             float cx = startX + x * cellSize;
             float cy = startY + y * cellSize;
-            if (maze[y][x].walls[0])
-                DrawGreenWall(cx, cy - wallThickness / 2.0f, cellSize, wallThickness);
-            if (maze[y][x].walls[1])
-                DrawGreenWall(cx, cy + cellSize - wallThickness / 2.0f, cellSize, wallThickness);
-            if (maze[y][x].walls[2])
-                DrawGreenWall(cx - wallThickness / 2.0f, cy, wallThickness, cellSize);
-            if (maze[y][x].walls[3])
-                DrawGreenWall(cx + cellSize - wallThickness / 2.0f, cy, wallThickness, cellSize);
+            if (maze.isPath(x, y))
+                DrawFloorTile(cx + pad, cy + pad, cellSize - 2 * pad, cellSize - 2 * pad);
+            else
+                DrawRectangle(static_cast<int>(cx + pad), static_cast<int>(cy + pad), static_cast<int>(cellSize - 2 * pad), static_cast<int>(cellSize - 2 * pad), Color{10, 10, 10, 255});
         }
     }
 
-    //// Start / End markers
-    // float sx = startX + cellSize / 2.0f, sy = startY + cellSize / 2.0f;
-    // float ex = startX + (mazeCols - 1) * cellSize + cellSize / 2.0f, ey = startY + (mazeRows - 1) * cellSize + cellSize / 2.0f;
-    // DrawCircleLines(static_cast<int>(sx), static_cast<int>(sy), static_cast<int>(cellSize * 0.33f), WHITE);
-    // DrawCircle(static_cast<int>(ex), static_cast<int>(ey), static_cast<int>(cellSize * 0.33f), RED);
+    // the live grid already has every trap in its current position
+    wallMesh.build(maze, v.firstX, v.firstY, v.lastX + 1, v.lastY + 1);
+    wallMesh.layout(startX, startY, cellSize, max(2.0f, cellSize * 0.16f), GreenWallStyle());
+    DrawWallMesh(wallMesh);
 }
 
-void DrawDecorations()
+void DrawMaze()
 {
+    MAZE_TRACE_SCOPE("DrawMaze");
+    MAZE_PROFILE_SCOPE(frameProfiler, PHASE_MAZE);
     if (mazeRows <= 0 || mazeCols <= 0)
         return;
     int mazeWidth = SCREEN_WIDTH - UI_PANEL_WIDTH;
-    float startX = (mazeWidth - mazeCols * cellSize) / 2.0f;
-    float startY = (SCREEN_HEIGHT - mazeRows * cellSize) / 2.0f;
+    UpdateMazeView();
+    float startX = mazeView.originX;
+    float startY = mazeView.originY;
 
-    for (int y = 0; y < mazeRows; ++y)
+    BeginScissorMode(0, 0, mazeWidth, SCREEN_HEIGHT);
+    if (!mazeView.whole)
+        DrawMazeWindow();
+    else
     {
-        for (int x = 0; x < mazeCols; ++x)
+        if (mazeLayerDirty || mazeLayerRows != mazeRows || mazeLayerCols != mazeCols || mazeLayerCellSize != cellSize)
+            BakeMazeLayer(startX, startY);
+        // render textures are stored upside down, hence the negative height
+        DrawTextureRec(mazeLayer.texture, {0, 0, static_cast<float>(mazeLayer.texture.width), -static_cast<float>(mazeLayer.texture.height)}, {0, 0}, WHITE);
+    }
+
+    // trap walls wherever they are closed right now
+    float wallThickness = max(2.0f, cellSize * 0.16f);
+    for (int i = 0; i < mazeTraps.size(); ++i)
+    {
+        const ShiftingWall &t = mazeTraps[i];
+        int cell = t.shifted ? t.gapCell : t.wallCell;
+        int side = t.shifted ? t.gapSide : t.wallSide;
+        if (!mazeView.contains(maze.xOf(cell), maze.yOf(cell)))
+            continue;
+        float cx = startX + maze.xOf(cell) * cellSize;
+        float cy = startY + maze.yOf(cell) * cellSize;
+        Color trap = Color{190, 90, 255, 255};
+        if (side == DIR_UP)
+            DrawRectangleRec({cx, cy - wallThickness / 2.0f, cellSize, wallThickness}, trap);
+        else if (side == DIR_DOWN)
+            DrawRectangleRec({cx, cy + cellSize - wallThickness / 2.0f, cellSize, wallThickness}, trap);
+        else if (side == DIR_LEFT)
+            DrawRectangleRec({cx - wallThickness / 2.0f, cy, wallThickness, cellSize}, trap);
+        else
+            DrawRectangleRec({cx + cellSize - wallThickness / 2.0f, cy, wallThickness, cellSize}, trap);
+    }
+
+    // the replay's newest cell in gold, older ones fading out behind it
+    if (currentState == STATE_REPLAY)
+    {
+        float pad = cellSize * 0.06f;
+        for (int age = replayTrail.size() - 1; age >= 0; --age)
         {
-            if (!maze[y][x].isPath)
+            Coord c = replayTrail.recent(age);
+            if (!mazeView.contains(c.x, c.y))
                 continue;
+            float fade = 1.0f - static_cast<float>(age) / replayTrail.trailLength();
+            float cx = startX + c.x * cellSize;
+            float cy = startY + c.y * cellSize;
+            DrawRectangle((int)(cx + pad), (int)(cy + pad),
+                          (int)(cellSize - 2 * pad), (int)(cellSize - 2 * pad),
+                          Fade(Color{255, 215, 0, 220}, fade)); // gold
+            DrawRectangleLines((int)(cx + pad), (int)(cy + pad),
+                               (int)(cellSize - 2 * pad), (int)(cellSize - 2 * pad),
+                               Fade(BLACK, 0.25f * fade));
+        }
+    }
+    EndScissorMode();
+}
 
-            float cx = startX + x * cellSize + cellSize / 2.0f;
-            float cy = startY + y * cellSize + cellSize / 2.0f;
+void DrawDecorations()
+{
+    MAZE_TRACE_SCOPE("DrawDecorations");
+    MAZE_PROFILE_SCOPE(frameProfiler, PHASE_DECORATIONS);
+    if (mazeRows <= 0 || mazeCols <= 0)
+        return;
+    if (!mazeView.contains(mazeCols - 1, mazeRows - 1))
+        return;
+    float startX = mazeView.originX;
+    float startY = mazeView.originY;
 
-            if (x == mazeCols - 1 && y == mazeRows - 1)
-            {
-                DrawCheeseIcon(cx, cy, cellSize * 0.25f);
-                continue;
-            }
+    // the cheese is the only decoration; it sits on the goal cell
+    DrawCheeseIcon(startX + (mazeCols - 1) * cellSize + cellSize / 2.0f,
+                   startY + (mazeRows - 1) * cellSize + cellSize / 2.0f, cellSize * 0.25f);
+}
+
+// ---------- Endless mode (chunked world around the player) ---------- //
+void DrawEndlessMaze()
+{
+    MAZE_TRACE_SCOPE("DrawEndlessMaze");
+    int mazeWidth = SCREEN_WIDTH - UI_PANEL_WIDTH;
+    float cs = ENDLESS_CELL_SIZE;
+    // the view is centred on the player; cell (x, y) sits at origin + (x, y) * cs
+    Vector2 at = PlayerDrawCell();
+    float originX = mazeWidth / 2.0f - (at.x + 0.5f) * cs;
+    float originY = SCREEN_HEIGHT / 2.0f - (at.y + 0.5f) * cs;
+    int x0 = static_cast<int>(floor(-originX / cs)), x1 = static_cast<int>(floor((mazeWidth - originX) / cs));
+    int y0 = static_cast<int>(floor(-originY / cs)), y1 = static_cast<int>(floor((SCREEN_HEIGHT - originY) / cs));
+
+    BeginScissorMode(0, 0, mazeWidth, SCREEN_HEIGHT);
+    float pad = cs * 0.06f;
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            DrawFloorTile(originX + x * cs + pad, originY + y * cs + pad, cs - 2 * pad, cs - 2 * pad);
+
+    float wallThickness = max(2.0f, cs * 0.16f);
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            float cx = originX + x * cs;
+            float cy = originY + y * cs;
+            unsigned char walls = endlessMaze.wallMask(x, y);
+            if (walls & (1 << DIR_UP))
+                DrawGreenWall(cx, cy - wallThickness / 2.0f, cs, wallThickness);
+            if (walls & (1 << DIR_DOWN))
+                DrawGreenWall(cx, cy + cs - wallThickness / 2.0f, cs, wallThickness);
+            if (walls & (1 << DIR_LEFT))
+                DrawGreenWall(cx - wallThickness / 2.0f, cy, wallThickness, cs);
+            if (walls & (1 << DIR_RIGHT))
+                DrawGreenWall(cx + cs - wallThickness / 2.0f, cy, wallThickness, cs);
         }
     }
+
+    DrawCircle(static_cast<int>(originX + cs / 2.0f), static_cast<int>(originY + cs / 2.0f), cs * 0.18f, RED);
+    DrawPlayerIcon(mazeWidth / 2.0f, SCREEN_HEIGHT / 2.0f, cs * 0.28f);
+    EndScissorMode();
+}
+
+void StartEndlessRun()
+{
+    endlessMode = true;
+    playerX = playerY = prevPlayerX = prevPlayerY = 0;
+    endlessMaze.reset(seedSource());
+    endlessMaze.ensureWindow(0, 0, ENDLESS_WINDOW_RADIUS);
+    mazeSearch.cancel();
+    mazeLoad.reset();
+    generatedMazes.clear();
+    currentState = STATE_COUNTDOWN;
+    countdownTimer = 3.0f;
+}
+
+// ---------- Background maze loading ---------- //
+// A maze asked for by seed or code is generated on the worker pool, like
+// the search candidates, and its distance field is built there too;
+// PollMazeGeneration() installs both. At 2000x2000 either step alone would
+// take a visible bite out of a frame on the UI thread.
+void RunMazeLoad(MazeLoad &l)
+{
+    MAZE_TRACE_SCOPE("RunMazeLoad");
+    if (l.fromSearch)
+    {
+        l.grid.assign(l.rows, l.cols, l.cellBytes);
+        l.cellBytes = vector<unsigned char>();
+    }
+    else if (l.targeted)
+    {
+        float lo, hi;
+        difficultyBand(l.level, lo, hi);
+        generateForDifficulty(l.grid, l.rows, l.cols, l.seed, lo, hi, &l.report);
+        l.score = l.report.score;
+    }
+    else
+    {
+        MazeMetrics shape;
+        generateMaze(l.grid, l.rows, l.cols, l.seed, l.algorithm, &shape);
+        l.score = difficultyScore(l.rows, l.cols, shape);
+    }
+    l.field.build(l.grid);
+    l.done.store(true, memory_order_release);
+}
+
+void SubmitMazeLoad(const shared_ptr<MazeLoad> &l)
+{
+    mazeLoad = l;
+    workerPool->submit([l]
+                       { RunMazeLoad(*l); });
+}
+
+// replaces whatever search or load was in progress
+void StartMazeLoad(const shared_ptr<MazeLoad> &l)
+{
+    mazeSearch.cancel();
+    generatedMazes.clear();
+    SubmitMazeLoad(l);
+}
+
+bool MazeLoading() { return mazeSearch.active() || mazeLoad != nullptr; }
+
+// ---------- Play a maze by seed ---------- //
+// A maze is shared as its seed. Difficulty-targeted mazes also depend on the
+// band they were steered to, so their code carries an E-, M- or H- prefix.
+string MazeCode()
+{
+    string code = formatSeed(currentMazeSeed);
+    if (!currentMazeTargeted)
+        return code;
+    if (currentDifficulty == DIFF_EASY)
+        return "E-" + code;
+    if (currentDifficulty == DIFF_MEDIUM)
+        return "M-" + code;
+    return "H-" + code;
+}
+
+bool ParseMazeCode(const string &code, bool &targeted, DifficultyLevel &level, unsigned long long &seed)
+{
+    targeted = code.size() > 2 && code[1] == '-';
+    if (targeted)
+    {
+        if (code[0] == 'E')
+            level = DIFF_EASY;
+        else if (code[0] == 'M')
+            level = DIFF_MEDIUM;
+        else if (code[0] == 'H')
+            level = DIFF_HARD;
+        else
+            return false;
+    }
+    return parseSeed(targeted ? code.substr(2) : code, seed);
+}
+
+// Plain seeds have no band; their scoreboard difficulty is the band the
+// maze's score falls in (or is nearest).
+DifficultyLevel DifficultyForScore(float score)
+{
+    DifficultyLevel best = DIFF_EASY;
+    float bestDist = 0.0f;
+    for (DifficultyLevel level : {DIFF_EASY, DIFF_MEDIUM, DIFF_HARD})
+    {
+        float lo, hi;
+        difficultyBand(level, lo, hi);
+        float dist = score < lo ? lo - score : (score > hi ? score - hi : 0.0f);
+        if (level == DIFF_EASY || dist < bestDist)
+        {
+            best = level;
+            bestDist = dist;
+        }
+    }
+    return best;
+}
+
+bool PlayMazeCode(const string &code)
+{
+    bool targeted;
+    DifficultyLevel level = DIFF_EASY;
+    unsigned long long seed;
+    if (!ParseMazeCode(code, targeted, level, seed))
+        return false;
+    endlessMode = false;
+    shared_ptr<MazeLoad> l = make_shared<MazeLoad>();
+    l->rows = mazeRows;
+    l->cols = mazeCols;
+    l->seed = seed;
+    l->targeted = targeted;
+    l->level = level;
+    l->algorithm = mazeAlgorithm;
+    StartMazeLoad(l);
+    currentState = STATE_COUNTDOWN;
+    countdownTimer = 3.0f;
+    return true;
+}
+
+// seed entry accepts hex digits plus the M-/H- code prefixes (E is a digit)
+bool IsMazeCodeChar(int c)
+{
+    return c < 128 && (isxdigit(c) || c == 'm' || c == 'M' || c == 'h' || c == 'H' || c == '-');
 }
 
 // ---------- Draw player ---------- //
 void DrawPlayer()
 {
+    MAZE_TRACE_SCOPE("DrawPlayer");
+    MAZE_PROFILE_SCOPE(frameProfiler, PHASE_PLAYER);
     if (cellSize <= 0)
         return;
-    int mazeWidth = SCREEN_WIDTH - UI_PANEL_WIDTH;
-    float startX = (mazeWidth - mazeCols * cellSize) / 2.0f;
-    float startY = (SCREEN_HEIGHT - mazeRows * cellSize) / 2.0f;
+    float startX = mazeView.originX;
+    float startY = mazeView.originY;
+    BeginScissorMode(0, 0, SCREEN_WIDTH - UI_PANEL_WIDTH, SCREEN_HEIGHT);
 
-    float px = startX + playerX * cellSize + cellSize / 2.0f;
-    float py = startY + playerY * cellSize + cellSize / 2.0f;
+    Vector2 at = PlayerDrawCell();
+    float px = startX + at.x * cellSize + cellSize / 2.0f;
+    float py = startY + at.y * cellSize + cellSize / 2.0f;
     DrawPlayerIcon(px, py, cellSize * 0.28f);
 
+    if (showHint && currentState == STATE_PLAYING && !mazeTraps.empty())
+    {
+        // the walls move, so the live path replaces the static distance field
+        for (size_t i = 1; i + 1 < livePath.size(); ++i)
+            if (mazeView.contains(livePath[i].x, livePath[i].y))
+                DrawCircle(static_cast<int>(startX + livePath[i].x * cellSize + cellSize / 2.0f),
+                           static_cast<int>(startY + livePath[i].y * cellSize + cellSize / 2.0f),
+                           max(1.5f, cellSize * 0.08f), Fade(YELLOW, 0.6f));
+    }
+    if (showHint && currentState == STATE_PLAYING && !goalDistance.empty())
+    {
+        int d = mazeTraps.empty() ? goalDistance.bestMove(playerX, playerY) : liveSolver.nextMove();
+        if (d >= 0 && d != DistanceField::NO_MOVE)
+        {
+            // arrow in the next cell on the shortest path, pointing along it
+            Vector2 dir = {static_cast<float>(DIR_DX[d]), static_cast<float>(DIR_DY[d])};
+            Vector2 mid = {px + dir.x * cellSize, py + dir.y * cellSize};
+            Vector2 tip = {mid.x + dir.x * cellSize * 0.3f, mid.y + dir.y * cellSize * 0.3f};
+            Vector2 a = {mid.x - dir.x * cellSize * 0.2f - dir.y * cellSize * 0.25f, mid.y - dir.y * cellSize * 0.2f + dir.x * cellSize * 0.25f};
+            Vector2 b = {mid.x - dir.x * cellSize * 0.2f + dir.y * cellSize * 0.25f, mid.y - dir.y * cellSize * 0.2f - dir.x * cellSize * 0.25f};
+            // raylib only fills counter-clockwise triangles
+            if ((a.x - tip.x) * (b.y - tip.y) - (a.y - tip.y) * (b.x - tip.x) > 0)
+                swap(a, b);
+            DrawTriangle(tip, a, b, Fade(YELLOW, 0.8f));
+        }
+    }
+
     float sx = startX + cellSize / 2.0f;
     float sy = startY + cellSize / 2.0f;
     DrawCircle(static_cast<int>(sx), static_cast<int>(sy),
                static_cast<int>(cellSize * 0.18f), RED);
+    EndScissorMode();
 }
 
 // the right panel
 void DrawHUD()
 {
+    MAZE_TRACE_SCOPE("DrawHUD");
+    MAZE_PROFILE_SCOPE(frameProfiler, PHASE_HUD);
     int panelX = SCREEN_WIDTH - UI_PANEL_WIDTH;
     DrawRectangle(panelX, 0, UI_PANEL_WIDTH, SCREEN_HEIGHT, UI_BLUE);
     if (currentState != STATE_REPLAY)
@@ -876,6 +908,19 @@ void DrawHUD()
         DrawText(TextFormat("TIME: %.2fs", gameTimer), panelX + 20, 90, 18, WHITE);
         DrawText(TextFormat("MOVES: %d", movesCount), panelX + 20, 120, 16, WHITE);
     }
+    DrawText(TextFormat("SEED: %s", endlessMode ? formatSeed(endlessMaze.seed()).c_str() : MazeCode().c_str()), panelX + 20, 150, 14, WHITE);
+    if (!endlessMode && lastMazeReport.attempts > 0)
+        DrawText(TextFormat("GENERATED IN %d TRIES, %.1f ms", lastMazeReport.attempts, lastMazeReport.ms), panelX + 20, 168, 12, WHITE);
+
+    if (endlessMode)
+    {
+        DrawText(TextFormat("FURTHEST: %d", endlessFurthest), panelX + 20, 190, 16, WHITE);
+        DrawText(TextFormat("CHUNKS: %d / %d loaded", endlessMaze.residentChunks(), endlessMaze.maxChunks()), panelX + 20, 215, 14, WHITE);
+        DrawText("Controls:", panelX + 20, 260, 14, WHITE);
+        DrawText("Arrow keys - move", panelX + 20, 285, 12, WHITE);
+        DrawText("Q - back to home", panelX + 20, 315, 12, WHITE);
+        return;
+    }
 
     // Difficulty bar
     DrawText("DIFFICULTY", panelX + 20, 190, 14, WHITE);
@@ -894,9 +939,79 @@ void DrawHUD()
     DrawRectangleLines(panelX + 20, 215, 200, 18, BLACK);
     DrawText("Controls:", panelX + 20, 260, 14, WHITE);
     DrawText("Arrow keys - move", panelX + 20, 285, 12, WHITE);
+    DrawText("Wheel or +/- - zoom", panelX + 20, 300, 12, WHITE);
     DrawText("Q - back to home", panelX + 20, 315, 12, WHITE);
+    DrawText(TextFormat("H - hint arrow (%s)", showHint ? "ON" : "OFF"), panelX + 20, 345, 12, WHITE);
+
+    if (currentState == STATE_END && runAnalysis.valid)
+    {
+        DrawText("RUN ANALYSIS", panelX + 20, 390, 16, WHITE);
+        DrawText(TextFormat("Moves: %d (shortest %d)", runAnalysis.moves, runAnalysis.optimalMoves), panelX + 20, 415, 12, WHITE);
+        DrawText(TextFormat("Extra moves: %d", runAnalysis.extraMoves), panelX + 20, 435, 12, runAnalysis.extraMoves ? MY_ORANGE : WHITE);
+        if (runAnalysis.firstDivergence < 0)
+            DrawText("Never left the shortest path", panelX + 20, 455, 12, WHITE);
+        else
+            DrawText(TextFormat("Left the shortest path at move %d", runAnalysis.firstDivergence), panelX + 20, 455, 12, WHITE);
+        DrawText(TextFormat("Backtracks: %d", runAnalysis.backtracks), panelX + 20, 475, 12, WHITE);
+        DrawText(TextFormat("Time in dead ends: %.2fs", runAnalysis.deadEndTime), panelX + 20, 495, 12, WHITE);
+    }
+    else if (currentState == STATE_PLAYING && !mazeTraps.empty())
+    {
+        // wasted moves mean nothing once the shortest path keeps changing
+        DrawText(TextFormat("TO CHEESE: %d", liveSolver.distance()), panelX + 20, 390, 16, WHITE);
+        DrawText(TextFormat("SHIFTING WALLS: %d", mazeTraps.size()), panelX + 20, 415, 16, Color{190, 90, 255, 255});
+        DrawText(TextFormat("Repair: %lld cells, %lld rebuilds", liveSolver.expandedLastUpdate(), liveSolver.rebuildCount()), panelX + 20, 440, 12, WHITE);
+    }
+    else if (currentState != STATE_REPLAY && !goalDistance.empty())
+    {
+        // live stats straight from the distance field: each move changes the
+        // distance to the cheese by one, so any move not closing in was wasted
+        int left = goalDistance.distance(playerX, playerY);
+        int wasted = movesCount - (goalDistance.distance(0, 0) - left);
+        DrawText(TextFormat("TO CHEESE: %d", left), panelX + 20, 390, 16, WHITE);
+        DrawText(TextFormat("MOVES WASTED: %d", wasted), panelX + 20, 415, 16, wasted ? MY_ORANGE : WHITE);
+    }
 }
 
+#ifndef MAZE_NO_PROFILER
+// Rolling averages and p99 over the last few seconds, plus a bar per frame
+// scaled so 33 ms fills the graph; the line marks the 60 FPS budget.
+void DrawProfilerOverlay()
+{
+    const int x = 10, y = 10, w = FrameProfiler::HISTORY + 20, graphH = 60;
+    int lines = frameProfiler.phaseCount() + 2;
+    int h = 14 * lines + graphH + 20;
+    DrawRectangle(x, y, w, h, Fade(BLACK, 0.75f));
+    // raylib's default font is proportional, so columns are placed by hand
+    const int avgX = x + 120, p99X = x + 180;
+    DrawText("phase", x + 8, y + 6, 10, YELLOW);
+    DrawText("avg ms", avgX, y + 6, 10, YELLOW);
+    DrawText("p99 ms", p99X, y + 6, 10, YELLOW);
+    DrawText("frame", x + 8, y + 20, 10, WHITE);
+    DrawText(TextFormat("%.2f", frameProfiler.averageMs(-1)), avgX, y + 20, 10, WHITE);
+    DrawText(TextFormat("%.2f", frameProfiler.p99Ms(-1)), p99X, y + 20, 10, WHITE);
+    for (int p = 0; p < frameProfiler.phaseCount(); ++p)
+    {
+        // maze..hud run inside draw, so they are indented under it
+        bool nested = p > PHASE_DRAW && p < PHASE_PRESENT;
+        int rowY = y + 34 + 14 * p;
+        DrawText(frameProfiler.phaseName(p).c_str(), x + (nested ? 20 : 8), rowY, 10, WHITE);
+        DrawText(TextFormat("%.2f", frameProfiler.averageMs(p)), avgX, rowY, 10, WHITE);
+        DrawText(TextFormat("%.2f", frameProfiler.p99Ms(p)), p99X, rowY, 10, WHITE);
+    }
+
+    int gx = x + 10, gy = y + h - 10;
+    for (int age = 0; age < frameProfiler.historySize(); ++age)
+    {
+        float ms = frameProfiler.frameMs(age);
+        int bar = static_cast<int>(min(1.0f, ms / 33.3f) * graphH);
+        DrawRectangle(gx + FrameProfiler::HISTORY - 1 - age, gy - bar, 1, bar, ms > 1000.0f / FPS + 1.0f ? RED : GREEN);
+    }
+    int budget = static_cast<int>(1000.0f / FPS / 33.3f * graphH);
+    DrawLine(gx, gy - budget, gx + FrameProfiler::HISTORY, gy - budget, Fade(YELLOW, 0.7f));
+}
+#endif
+
 // ---------- Update hover ---------- //
 void UpdateHoversMain()
 {
@@ -914,8 +1029,12 @@ void UpdateHoversMain()
         for (auto &b : diffButtons)
             b.checkHover(m);
     else if (currentState == STATE_END && !endButtons.empty())
+    {
         for (auto &b : endButtons)
             b.checkHover(m);
+        for (auto &b : compareButtons)
+            b.checkHover(m);
+    }
 
     else if (currentState == STATE_PLAYING)
         pauseBtn.checkHover(m);
@@ -924,27 +1043,9 @@ void UpdateHoversMain()
 // ---------- End comparison / replay ---------- //
 void ShowEndComparison()
 {
-    bool perfect = false;
-    if (playerPath.getSize() == static_cast<int>(solutionPath.size()))
-    {
-        perfect = true;
-        auto *n = playerPath.getHead();
-        for (size_t i = 0; i < solutionPath.size() && n; ++i)
-        {
-            const Coord &pos = solutionPath[i];
-            if (n->data.x != pos.x || n->data.y != pos.y)
-            {
-                perfect = false;
-                break;
-            }
-
-            n = n->next;
-        }
-    }
-
     int cx = (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2;
     int cy = SCREEN_HEIGHT / 3;
-    if (perfect)
+    if (runAnalysis.perfect)
     {
         DrawCenteredTextShadow("PERFECT RUN!", cx, cy, 40, Color{200, 255, 200, 255});
         DrawCenteredTextShadow("You found the shortest path!", cx, cy + 56, 22, GREENDARK);
@@ -953,198 +1054,336 @@ void ShowEndComparison()
     {
         DrawCenteredTextShadow("GOOD EFFORT!", cx, cy, 40, MY_ORANGE);
         DrawCenteredTextShadow("View optimal path or replay your path", cx, cy + 56, 20, DARKORANGE);
+        for (auto &b : compareButtons)
+            b.draw();
+    }
+}
 
-        // OPTIMAL / REPLAY buttons
-        Button opt(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 100.0f, 300, 60, "OPTIMAL PATH", Color{70, 130, 255, 255}, BLUEDARK);
-        Button rep(static_cast<float>(cx) - 150.0f, static_cast<float>(cy) + 160.0f, 300, 60, "REPLAY MY PATH", Color{40, 200, 120, 255}, GREENDARK);
-        Vector2 m = GetMousePosition();
-        opt.checkHover(m);
-        rep.checkHover(m);
-        opt.draw();
-        rep.draw();
+// Fills runAnalysis from the finished run. The shortest path comes from the
+// distance field by following best moves from the start, so nothing is
+// solved here; the player path is walked once.
+void AnalyzeRun()
+{
+    RunAnalysis r;
+    r.valid = !goalDistance.empty();
+    if (!r.valid)
+    {
+        runAnalysis = r;
+        return;
+    }
+    r.moves = movesCount;
+    if (liveRun)
+    {
+        // a step toward the cheese lowers the live distance by one; any other
+        // step costs the difference plus the step itself
+        for (const LiveStep &s : liveSteps)
+            if (s.before >= 0 && s.after >= 0)
+                r.extraMoves += s.after - s.before + 1;
+        r.optimalMoves = r.moves - r.extraMoves;
+    }
+    else
+    {
+        r.optimalMoves = goalDistance.distance(0, 0);
+        r.extraMoves = max(0, r.moves - r.optimalMoves);
+    }
+    r.perfect = r.extraMoves == 0;
 
-        if (opt.clicked(m) && !solutionPath.empty())
-        {
-            for (auto &row : maze)
-                for (auto &c : row)
-                    c.isReplay = false;
-
-            replayPath = solutionPath;
-            replayIndex = 0;
-            replayTimer = 0.0f;
-            replaySessionIsSolution = true;
-            currentState = STATE_REPLAY;
-        }
+    onShortestPath.assign(maze.size(), 0);
+    int x = 0, y = 0;
+    onShortestPath[0] = 1;
+    for (int d = goalDistance.bestMove(x, y); d != DistanceField::NO_MOVE; d = goalDistance.bestMove(x, y))
+    {
+        x += DIR_DX[d];
+        y += DIR_DY[d];
+        onShortestPath[maze.index(x, y)] = 1;
+    }
 
-        if (rep.clicked(m))
+    int prev = -1, beforePrev = -1, prevDist = 0, move = 0;
+    float prevTime = 0.0f;
+    for (auto *n = playerPath.getHead(); n; n = n->next, ++move)
+    {
+        int cell = maze.index(n->data.x, n->data.y);
+        int dist = goalDistance.distance(n->data.x, n->data.y);
+        if (move > 0)
         {
-            replayPath.clear();
-            auto *n = playerPath.getHead();
-            while (n)
+            bool closer, onPath;
+            if (liveRun && move <= static_cast<int>(liveSteps.size()))
             {
-                replayPath.push_back({n->data.x, n->data.y});
-                n = n->next;
+                const LiveStep &s = liveSteps[move - 1];
+                closer = onPath = s.after < s.before;
             }
-
-            for (auto &row : maze)
-                for (auto &c : row)
-                    c.isReplay = false;
-
-            replayIndex = 0;
-            replayTimer = 0.0f;
-            replaySessionIsSolution = false;
-            currentState = STATE_REPLAY;
+            else
+            {
+                closer = dist < prevDist;
+                onPath = onShortestPath[cell] && onShortestPath[prev];
+            }
+            if (r.firstDivergence < 0 && !closer)
+                r.firstDivergence = move;
+            if (cell == beforePrev)
+                ++r.backtracks;
+            if (!onPath)
+                r.deadEndTime += n->data.t - prevTime;
         }
+        beforePrev = prev;
+        prev = cell;
+        prevDist = dist;
+        prevTime = n->data.t;
     }
+    runAnalysis = r;
 }
 
-float evaluateDifficulty(int rows, int cols);
-
 // ---------- Reset and start ---------- //
 void ResetGameWithCurrentMaze()
 {
-    if (generatedMazes.empty())
+    if (endlessMode)
     {
-        generateFullMaze(mazeRows, mazeCols);
-        currentMazeScore = evaluateDifficulty(mazeRows, mazeCols);
+        // nothing to solve and no replay: the world has no goal and the path
+        // would grow without bound
+        playerX = playerY = prevPlayerX = prevPlayerY = movesCount = endlessFurthest = 0;
+        gameTimer = 0.0f;
+        gameTicks = 0;
+        pendingMoves.clear();
+        countdownTimer = 3.0f;
+        gamePaused = false;
+        playerPath.clear();
+        solutionPath.clear();
+        replayPath.clear();
+        gameCompleted = false;
+        return;
     }
-    playerX = 0;
-    playerY = 0;
+    playerX = prevPlayerX = 0;
+    playerY = prevPlayerY = 0;
     movesCount = 0;
     gameTimer = 0.0f;
+    gameTicks = 0;
+    pendingMoves.clear();
     countdownTimer = 3.0f;
     gamePaused = false;
     playerPath.clear();
     playerPath.add(PlayerMove(playerX, playerY, 0.0f));
     solutionPath.clear();
-    for (auto *c : BFSSolve())
+    runAnalysis = RunAnalysis();
+    if (shiftingWallsMode && maze.size() <= SHIFTING_WALLS_MAX_CELLS)
     {
-        solutionPath.push_back({c->x, c->y});
+        // one trap per 40 cells; the seed ties the traps to the maze seed
+        mazeTraps.place(maze, deriveSeed(currentMazeSeed, 1), max(4, maze.size() / 40));
+        InvalidateMazeLayer();
+        liveSolver.reset(maze, 0, maze.size() - 1);
+        liveSolver.path(livePath);
     }
+    liveRun = !mazeTraps.empty();
+    liveSteps.clear();
 
     replayPath.clear();
     replayIndex = 0;
-    replayTimer = 0.0f;
+    replayTicks = 0;
     gameCompleted = false;
 }
 
-// ---------- Evaluate difficulty quick helper ---------- //
-float evaluateDifficulty(int rows, int cols)
+// ---------- Shifting walls ---------- //
+// Moves the traps that are due this tick and hands every moved wall to the
+// live solver. The player's own step arrives through moveStart() in
+// TryMovePlayer.
+void UpdateShiftingWalls(float dt)
 {
-    if (maze.empty())
-        return 0.0f;
-    int R = rows, C = cols;
-    int total = R * C, deadEnds = 0, branches = 0, maxCoord = 0;
-    for (int y = 0; y < R; ++y)
-        for (int x = 0; x < C; ++x)
-        {
-            int open = 0;
-            for (int k = 0; k < 4; ++k)
-                if (!maze[y][x].walls[k])
-                    open++;
-            if (open == 1)
-                deadEnds++;
-            if (open >= 3)
-                branches++;
-            if (x + y > maxCoord)
-                maxCoord = x + y;
-        }
-    float deadRatio = static_cast<float>(deadEnds) / static_cast<float>(total);
-    float branchRatio = static_cast<float>(branches) / static_cast<float>(total);
-    float pathRatio = static_cast<float>(maxCoord) / static_cast<float>(R + C);
-    float score = (deadRatio * 40.0f) + (branchRatio * 35.0f) + (pathRatio * 25.0f);
-    score = min(score * 100.0f, 100.0f);
-    return score;
+    movedTraps.clear();
+    mazeTraps.update(maze, dt, movedTraps);
+    for (int i : movedTraps)
+    {
+        const ShiftingWall &t = mazeTraps[i];
+        liveSolver.wallChanged(t.wallCell, t.wallSide);
+        liveSolver.wallChanged(t.gapCell, t.gapSide);
+    }
+}
+
+// once per frame: the solver repairs only what the frame's ticks changed
+void RepairLivePath()
+{
+    liveSolver.update();
+    liveSolver.path(livePath);
+}
+
+// Puts the maze back the way it was generated, so the end screen, replays
+// and the next run all see the original walls.
+void StopShiftingWalls()
+{
+    if (!mazeTraps.empty())
+        InvalidateMazeLayer();
+    mazeTraps.restore(maze);
+    livePath.clear();
+}
+
+// Records the time and score of a run that reached the cheese and moves on
+// to the end screen.
+void FinishRun()
+{
+    gameCompleted = true;
+    PlayerScore ps(playerName, gameTimer, currentDifficulty, CurrentDateTime());
+    if (currentDifficulty == DIFF_EASY)
+        easyScores.add(ps);
+    else if (currentDifficulty == DIFF_MEDIUM)
+        mediumScores.add(ps);
+    else
+        hardScores.add(ps);
+    SaveScoreToFile(ps);
+    StopShiftingWalls();
+    AnalyzeRun();
+    currentState = STATE_END;
 }
 
-// ---------- Multi-maze generate & pick (simple) ---------- //
+// ---------- Multi-maze generate & pick (background) ---------- //
+// Queues mazeCandidateCount candidates on the worker pool; the countdown
+// waits on PollMazeGeneration() instead of blocking the UI thread. Targeted
+// candidates steer toward the band, so a single one normally suffices.
 void GenerateMultipleMazesAndPick()
 {
+    MAZE_TRACE_SCOPE("GenerateMultipleMazesAndPick");
+    mazeLoad.reset();
     generatedMazes.clear();
-    const int N = 6;
-    for (int i = 0; i < N; ++i)
+    CandidateSearchParams p;
+    p.rows = mazeRows;
+    p.cols = mazeCols;
+    p.candidates = mazeCandidateCount;
+    p.algorithm = mazeAlgorithm;
+    p.targeted = mazeTargeted;
+    p.baseSeed = seedSource();
+    difficultyBand(currentDifficulty, p.minScore, p.maxScore);
+    mazeSearch.start(*workerPool, p);
+}
+
+// Installs the loaded maze and its distance field once the worker is done;
+// a finished search hands its picked candidate to a load first. A maze of
+// the wrong size (nothing was asked for since the size changed) is
+// replaced by a fresh one the same way. Returns false while anything is
+// still running.
+bool PollMazeGeneration()
+{
+    if (mazeSearch.active())
     {
-        generateFullMaze(mazeRows, mazeCols);
-        float sc = evaluateDifficulty(mazeRows, mazeCols);
-        MazeDifficulty md(i, sc, mazeRows, mazeCols);
-        md.cellBytes.resize(mazeRows * mazeCols);
-        for (int y = 0; y < mazeRows; ++y)
-            for (int x = 0; x < mazeCols; ++x)
-            {
-                unsigned char b = 0;
-                if (maze[y][x].walls[0])
-                    b |= 1 << 0;
-                if (maze[y][x].walls[1])
-                    b |= 1 << 1;
-                if (maze[y][x].walls[2])
-                    b |= 1 << 2;
-                if (maze[y][x].walls[3])
-                    b |= 1 << 3;
-                if (maze[y][x].isPath)
-                    b |= 1 << 4;
-                md.cellBytes[y * mazeCols + x] = b;
-            }
-        generatedMazes.push_back(md);
+        if (!mazeSearch.ready())
+            return false;
+        MazeDifficulty md;
+        if (mazeSearch.take(md, &generatedMazes, &lastMazeReport))
+        {
+            shared_ptr<MazeLoad> l = make_shared<MazeLoad>();
+            l->rows = md.rows;
+            l->cols = md.cols;
+            l->seed = md.seed;
+            l->targeted = mazeTargeted;
+            l->fromSearch = true;
+            l->cellBytes = std::move(md.cellBytes);
+            l->score = md.score;
+            SubmitMazeLoad(l);
+        }
     }
-    float minS = 0, maxS = 100;
-    if (currentDifficulty == DIFF_EASY)
+    if (!mazeLoad && !endlessMode && (maze.getRows() != mazeRows || maze.getCols() != mazeCols))
     {
-        minS = 0;
-        maxS = 33;
+        shared_ptr<MazeLoad> l = make_shared<MazeLoad>();
+        l->rows = mazeRows;
+        l->cols = mazeCols;
+        l->seed = seedSource();
+        l->algorithm = mazeAlgorithm;
+        StartMazeLoad(l);
     }
-    else if (currentDifficulty == DIFF_MEDIUM)
+    if (!mazeLoad)
+        return true;
+    if (!mazeLoad->done.load(memory_order_acquire))
+        return false;
+    MazeLoad &l = *mazeLoad;
+    maze = std::move(l.grid);
+    goalDistance = std::move(l.field);
+    InvalidateMazeLayer();
+    currentMazeSeed = l.seed;
+    currentMazeTargeted = l.targeted;
+    currentMazeScore = l.score;
+    if (!l.fromSearch)
     {
-        minS = 34;
-        maxS = 66;
+        currentDifficulty = l.targeted ? l.level : DifficultyForScore(l.score);
+        lastMazeReport = CandidateSearchReport();
+        if (l.targeted)
+        {
+            lastMazeReport.built = 1;
+            lastMazeReport.attempts = l.report.attempts;
+            lastMazeReport.ms = l.report.ms;
+        }
     }
-    else
+    mazeLoad.reset();
+    return true;
+}
+
+// ---------- Player movement ---------- //
+bool CanMove(int x, int y, int d)
+{
+    if (endlessMode)
+        return !endlessMaze.hasWall(x, y, d);
+    return maze.inBounds(x + DIR_DX[d], y + DIR_DY[d]) && !maze.hasWall(x, y, d);
+}
+
+void TryMovePlayer(int d)
+{
+    if (!CanMove(playerX, playerY, d))
+        return;
+    prevPlayerX = playerX;
+    prevPlayerY = playerY;
+    playerX += DIR_DX[d];
+    playerY += DIR_DY[d];
+    movesCount++;
+    if (endlessMode)
     {
-        minS = 67;
-        maxS = 100;
+        endlessFurthest = max(endlessFurthest, abs(playerX) + abs(playerY));
+        endlessMaze.ensureWindow(playerX, playerY, ENDLESS_WINDOW_RADIUS);
     }
-    sort(generatedMazes.begin(), generatedMazes.end(), [](const MazeDifficulty &a, const MazeDifficulty &b)
-         { return a.score > b.score; });
-    bool found = false;
-    for (auto &md : generatedMazes)
+    else
+        playerPath.add(PlayerMove(playerX, playerY, gameTimer));
+    if (!mazeTraps.empty())
     {
-        if (md.score >= minS && md.score <= maxS)
-        {
-            maze.clear();
-            maze.resize(md.rows, vector<Cell>(md.cols));
-            for (int y = 0; y < md.rows; ++y)
-                for (int x = 0; x < md.cols; ++x)
-                {
-                    maze[y][x] = Cell(x, y);
-                    unsigned char b = md.cellBytes[y * md.cols + x];
-                    maze[y][x].walls[0] = (b & (1 << 0)) != 0;
-                    maze[y][x].walls[1] = (b & (1 << 1)) != 0;
-                    maze[y][x].walls[2] = (b & (1 << 2)) != 0;
-                    maze[y][x].walls[3] = (b & (1 << 3)) != 0;
-                    maze[y][x].isPath = (b & (1 << 4)) != 0;
-                }
-            currentMazeScore = md.score;
-            found = true;
-            break;
-        }
+        // walls moved earlier this frame are only repaired once per frame,
+        // so bring the distances up to date on both sides of the step
+        liveSolver.update();
+        int before = liveSolver.distance();
+        liveSolver.moveStart(maze.index(playerX, playerY));
+        liveSolver.update();
+        liveSteps.push_back({before, liveSolver.distance()});
     }
-    if (!found)
-        currentMazeScore = evaluateDifficulty(mazeRows, mazeCols);
 }
 
-int main()
+int main(int argc, char **argv)
 {
-    rng.seed((unsigned)chrono::system_clock::now().time_since_epoch().count());
+    int workerThreads = 0;
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (string(argv[i]) == "--candidates")
+            mazeCandidateCount = max(1, atoi(argv[++i]));
+        else if (string(argv[i]) == "--threads")
+            workerThreads = atoi(argv[++i]);
+        else if (string(argv[i]) == "--algo")
+        {
+            mazeAlgorithm = string(argv[++i]) == "eller" ? ALGO_ELLER : ALGO_BACKTRACKER;
+            mazeTargeted = false;
+        }
+        else if (string(argv[i]) == "--fps")
+            targetFps = max(0, atoi(argv[++i]));
+        else if (string(argv[i]) == "--trace")
+            traceStart(argv[++i]);
+        else if (string(argv[i]) == "--solver")
+        {
+            SolverKind kind;
+            if (parseSolverKind(argv[++i], kind))
+                mazeSolver = makeSolver(kind);
+        }
+    }
+    if (!mazeSolver)
+        mazeSolver = makeSolver(SOLVER_BFS);
+    MAZE_TRACE_THREAD_NAME("main");
+    workerPool.reset(new WorkerPool(workerThreads));
 
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Maze Runner");
-    SetTargetFPS(FPS);
+    SetTargetFPS(targetFps);
 
     InitUI();
-    generateFullMaze(mazeRows, mazeCols);
-    solutionPath.clear();
-    for (auto *c : BFSSolve())
-    {
-        solutionPath.push_back({c->x, c->y});
-    }
+    currentMazeSeed = seedSource();
+    generateMaze(maze, mazeRows, mazeCols, currentMazeSeed, mazeAlgorithm);
+    goalDistance.build(maze);
     playerPath.clear();
     playerPath.add(PlayerMove(0, 0, 0.0f));
 
@@ -1159,8 +1398,18 @@ int main()
 
     while (!WindowShouldClose() && !shouldClose)
     {
-        float dt = GetFrameTime();
+        MAZE_PROFILE_BEGIN_FRAME(frameProfiler);
+        MAZE_TRACE_BEGIN("frame");
+        simAccumulator += GetFrameTime();
+        int ticks = static_cast<int>(simAccumulator / SIM_DT);
+        simAccumulator -= ticks * static_cast<double>(SIM_DT);
+        simTick += ticks;
+#ifndef MAZE_NO_PROFILER
+        if (IsKeyPressed(KEY_F3))
+            showProfiler = !showProfiler;
+#endif
         UpdateHoversMain();
+        MAZE_PROFILE_LAP(frameProfiler, PHASE_HOVERS);
         if (currentState == STATE_PLAYING && musicEnabled)
         {
             if (!musicPlaying)
@@ -1176,6 +1425,8 @@ int main()
             StopMusicStream(backgroundMusic);
             musicPlaying = false;
         }
+        MAZE_PROFILE_LAP(frameProfiler, PHASE_MUSIC);
+        MAZE_TRACE_BEGIN("update");
         switch (currentState)
         {
         case STATE_HOME:
@@ -1230,6 +1481,8 @@ int main()
         case STATE_SIZE_SELECT:
         {
             Vector2 m = GetMousePosition();
+            if (sizeButtons[0].clicked(m) || sizeButtons[1].clicked(m) || sizeButtons[2].clicked(m) || sizeButtons[3].clicked(m))
+                endlessMode = false;
             if (sizeButtons[0].clicked(m))
             {
                 mazeRows = mazeCols = SIZE_SMALL;
@@ -1245,6 +1498,18 @@ int main()
                 mazeRows = mazeCols = SIZE_LARGE;
                 currentState = STATE_DIFFICULTY_SELECT;
             }
+            if (sizeButtons[3].clicked(m))
+            {
+                mazeRows = mazeCols = SIZE_HUGE;
+                currentState = STATE_DIFFICULTY_SELECT;
+            }
+            if (sizeButtons[4].clicked(m))
+                StartEndlessRun();
+            if (sizeButtons[5].clicked(m))
+            {
+                shiftingWallsMode = !shiftingWallsMode;
+                sizeButtons[5].text = shiftingWallsMode ? "SHIFTING WALLS: ON" : "SHIFTING WALLS: OFF";
+            }
             if (IsKeyPressed(KEY_Q))
                 currentState = STATE_HOME;
             break;
@@ -1273,13 +1538,44 @@ int main()
                 currentState = STATE_COUNTDOWN;
                 countdownTimer = 3.0f;
             }
+            if (diffButtons[3].clicked(m))
+            {
+                seedInput.clear();
+                currentState = STATE_SEED_ENTRY;
+            }
             if (IsKeyPressed(KEY_Q))
                 currentState = STATE_SIZE_SELECT;
             break;
         }
+        case STATE_SEED_ENTRY:
+        {
+            if (IsKeyPressed(KEY_ENTER) && PlayMazeCode(seedInput))
+                break;
+            if (IsKeyPressed(KEY_BACKSPACE) && !seedInput.empty())
+                seedInput.pop_back();
+            if ((IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL)) && IsKeyPressed(KEY_V))
+            {
+                const char *clip = GetClipboardText();
+                for (; clip && *clip && seedInput.length() < 18; ++clip)
+                    if (IsMazeCodeChar(static_cast<unsigned char>(*clip)))
+                        seedInput += static_cast<char>(toupper(static_cast<unsigned char>(*clip)));
+            }
+            if (IsKeyPressed(KEY_Q))
+                currentState = STATE_DIFFICULTY_SELECT;
+            int key = GetCharPressed();
+            while (key > 0)
+            {
+                if (IsMazeCodeChar(key) && seedInput.length() < 18)
+                    seedInput += static_cast<char>(toupper(key));
+                key = GetCharPressed();
+            }
+            break;
+        }
         case STATE_COUNTDOWN:
         {
-            countdownTimer -= dt;
+            if (!PollMazeGeneration())
+                break;
+            countdownTimer -= ticks * SIM_DT;
             if (countdownTimer <= 0.0f)
             {
                 currentState = STATE_PLAYING;
@@ -1291,45 +1587,41 @@ int main()
         {
             if (!gamePaused)
             {
-                gameTimer += dt;
-                if (IsKeyPressed(KEY_UP) && playerY > 0 && !maze[playerY][playerX].walls[0])
-                {
-                    playerY--;
-                    movesCount++;
-                    playerPath.add(PlayerMove(playerX, playerY, gameTimer));
-                }
-                if (IsKeyPressed(KEY_DOWN) && playerY < mazeRows - 1 && !maze[playerY][playerX].walls[1])
-                {
-                    playerY++;
-                    movesCount++;
-                    playerPath.add(PlayerMove(playerX, playerY, gameTimer));
-                }
-                if (IsKeyPressed(KEY_LEFT) && playerX > 0 && !maze[playerY][playerX].walls[2])
-                {
-                    playerX--;
-                    movesCount++;
-                    playerPath.add(PlayerMove(playerX, playerY, gameTimer));
-                }
-                if (IsKeyPressed(KEY_RIGHT) && playerX < mazeCols - 1 && !maze[playerY][playerX].walls[3])
-                {
-                    playerX++;
-                    movesCount++;
-                    playerPath.add(PlayerMove(playerX, playerY, gameTimer));
-                }
-
-                if (playerX == mazeCols - 1 && playerY == mazeRows - 1)
+                if (IsKeyPressed(KEY_UP))
+                    pendingMoves.push_back(DIR_UP);
+                if (IsKeyPressed(KEY_DOWN))
+                    pendingMoves.push_back(DIR_DOWN);
+                if (IsKeyPressed(KEY_LEFT))
+                    pendingMoves.push_back(DIR_LEFT);
+                if (IsKeyPressed(KEY_RIGHT))
+                    pendingMoves.push_back(DIR_RIGHT);
+                for (int t = 0; t < ticks; ++t)
                 {
-                    gameCompleted = true;
-                    PlayerScore ps(playerName, gameTimer, currentDifficulty, CurrentDateTime());
-                    if (currentDifficulty == DIFF_EASY)
-                        easyScores.add(ps);
-                    else if (currentDifficulty == DIFF_MEDIUM)
-                        mediumScores.add(ps);
-                    else
-                        hardScores.add(ps);
-                    SaveScoreToFile(ps);
-                    currentState = STATE_END;
+                    // the frame's moves take effect at its first tick, and
+                    // the run ends on the tick the cheese is reached
+                    if (!pendingMoves.empty())
+                    {
+                        for (int d : pendingMoves)
+                            TryMovePlayer(d);
+                        pendingMoves.clear();
+                        playerMoveTick = simTick - ticks + t;
+                    }
+                    if (!endlessMode && playerX == mazeCols - 1 && playerY == mazeRows - 1)
+                    {
+                        FinishRun();
+                        break;
+                    }
+                    ++gameTicks;
+                    gameTimer = static_cast<float>(gameTicks) / SIM_HZ;
+                    if (!mazeTraps.empty())
+                        UpdateShiftingWalls(SIM_DT);
                 }
+                if (IsKeyPressed(KEY_H) && !endlessMode)
+                    showHint = !showHint;
+                if (!mazeTraps.empty() && currentState == STATE_PLAYING)
+                    RepairLivePath();
+                if (!endlessMode)
+                    HandleZoomInput();
             }
 
             Vector2 m = GetMousePosition();
@@ -1361,6 +1653,7 @@ int main()
 
             if (IsKeyPressed(KEY_Q))
             {
+                StopShiftingWalls();
                 currentState = STATE_HOME;
                 gameCompleted = false;
             }
@@ -1384,6 +1677,32 @@ int main()
             {
                 currentState = STATE_HOME;
             }
+            else if (!runAnalysis.perfect && compareButtons[0].clicked(m))
+            {
+                // solved only now: most runs never ask for the optimal path
+                if (solutionPath.empty())
+                    mazeSolver->solve(maze, solutionPath);
+                if (!solutionPath.empty())
+                {
+                    replayTrail.clear();
+                    replayPath = solutionPath;
+                    replayIndex = 0;
+                    replayTicks = 0;
+                    replaySessionIsSolution = true;
+                    currentState = STATE_REPLAY;
+                }
+            }
+            else if (!runAnalysis.perfect && compareButtons[1].clicked(m))
+            {
+                replayPath.clear();
+                for (auto *n = playerPath.getHead(); n; n = n->next)
+                    replayPath.push_back({n->data.x, n->data.y});
+                replayTrail.clear();
+                replayIndex = 0;
+                replayTicks = 0;
+                replaySessionIsSolution = false;
+                currentState = STATE_REPLAY;
+            }
             break;
         }
         case STATE_SCOREBOARD:
@@ -1394,20 +1713,17 @@ int main()
         }
         case STATE_REPLAY:
         {
-            replayTimer += dt;
+            HandleZoomInput();
 
-            if (replayTimer >= 0.12f &&
-                replayIndex < (int)replayPath.size())
+            for (int t = 0; t < ticks; ++t)
             {
-
-                for (auto &row : maze)
-                    for (auto &c : row)
-                        c.isReplay = false;
-
-                const Coord pos = replayPath[replayIndex];
-                maze[pos.y][pos.x].isReplay = true;
-                replayIndex++;
-                replayTimer = 0.0f;
+                if (++replayTicks >= REPLAY_STEP_TICKS &&
+                    replayIndex < (int)replayPath.size())
+                {
+                    replayTrail.step(replayPath[replayIndex]);
+                    replayIndex++;
+                    replayTicks = 0;
+                }
             }
 
             if (replaySessionIsSolution)
@@ -1424,15 +1740,16 @@ int main()
 
             if (IsKeyPressed(KEY_Q))
             {
-                for (auto &row : maze)
-                    for (auto &c : row)
-                        c.isReplay = false;
+                replayTrail.clear();
                 currentState = STATE_END;
             }
             break;
         }
         }
+        MAZE_PROFILE_LAP(frameProfiler, PHASE_UPDATE);
+        MAZE_TRACE_END();
 
+        MAZE_TRACE_BEGIN("draw");
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
@@ -1474,30 +1791,60 @@ int main()
                 b.draw();
             DrawText("Q: Back to Home", 24, SCREEN_HEIGHT - 40, 14, Color{200, 200, 200, 220});
         }
+        else if (currentState == STATE_SEED_ENTRY)
+        {
+            DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Color{18, 18, 18, 255});
+            DrawCenteredTextShadow("ENTER MAZE SEED", SCREEN_WIDTH / 2, 200, 32, WHITE);
+            DrawCenteredTextShadow(TextFormat("%dx%d maze: [E-|M-|H-] + up to 16 hex digits (ENTER to play)", mazeCols, mazeRows), SCREEN_WIDTH / 2, 280, 20, Color{200, 200, 200, 255});
+            DrawRectangle(SCREEN_WIDTH / 2 - 200, 320, 400, 60, UI_BLUE);
+            DrawRectangleLinesEx({SCREEN_WIDTH / 2 - 200, 320, 400, 60}, 2, BLACK);
+            DrawText(seedInput.c_str(), SCREEN_WIDTH / 2 - MeasureText(seedInput.c_str(), 32) / 2, 335, 32, WHITE);
+            DrawText((GetTime() * 2 > (int)(GetTime() * 2)) ? "|" : "", SCREEN_WIDTH / 2 + MeasureText(seedInput.c_str(), 32) / 2 + 5, 335, 32, WHITE);
+            DrawCenteredTextShadow(TextFormat("Last maze: %s", MazeCode().c_str()), SCREEN_WIDTH / 2, 400, 18, Color{200, 200, 200, 255});
+            DrawText("Q: Back", 24, SCREEN_HEIGHT - 40, 14, Color{200, 200, 200, 220});
+        }
         else if (currentState == STATE_COUNTDOWN)
         {
             DrawRectangle(0, 0, SCREEN_WIDTH - UI_PANEL_WIDTH, SCREEN_HEIGHT, Color{18, 18, 18, 255});
             DrawRectangle(SCREEN_WIDTH - UI_PANEL_WIDTH, 0, UI_PANEL_WIDTH, SCREEN_HEIGHT, UI_BLUE);
             DrawLine(SCREEN_WIDTH - UI_PANEL_WIDTH, 0, SCREEN_WIDTH - UI_PANEL_WIDTH, SCREEN_HEIGHT, UI_BLUE);
-            DrawMaze();
-            DrawPlayer();
-            if (countdownTimer > 2.0f)
-                DrawCenteredTextShadow("3", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, RED);
-            else if (countdownTimer > 1.0f)
-                DrawCenteredTextShadow("2", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, MY_ORANGE);
-            else if (countdownTimer > 0.0f)
-                DrawCenteredTextShadow("1", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, YELLOW);
+            if (MazeLoading())
+            {
+                // the grid still holds the previous maze until the new one is installed
+                DrawCenteredTextShadow("GENERATING MAZE...", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 20, 32, WHITE);
+            }
             else
-                DrawCenteredTextShadow("GO!", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, Color{120, 255, 120, 255});
+            {
+                if (endlessMode)
+                    DrawEndlessMaze();
+                else
+                {
+                    DrawMaze();
+                    DrawPlayer();
+                }
+                if (countdownTimer > 2.0f)
+                    DrawCenteredTextShadow("3", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, RED);
+                else if (countdownTimer > 1.0f)
+                    DrawCenteredTextShadow("2", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, MY_ORANGE);
+                else if (countdownTimer > 0.0f)
+                    DrawCenteredTextShadow("1", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, YELLOW);
+                else
+                    DrawCenteredTextShadow("GO!", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, SCREEN_HEIGHT / 2 - 40, 120, Color{120, 255, 120, 255});
+            }
         }
         else if (currentState == STATE_PLAYING)
         {
             DrawRectangle(0, 0, SCREEN_WIDTH - UI_PANEL_WIDTH, SCREEN_HEIGHT, Color{18, 18, 18, 255});
             DrawRectangle(SCREEN_WIDTH - UI_PANEL_WIDTH, 0, UI_PANEL_WIDTH, SCREEN_HEIGHT, PANEL_GRAY);
             DrawLine(SCREEN_WIDTH - UI_PANEL_WIDTH, 0, SCREEN_WIDTH - UI_PANEL_WIDTH, SCREEN_HEIGHT, GRAY);
-            DrawMaze();
-            DrawDecorations();
-            DrawPlayer();
+            if (endlessMode)
+                DrawEndlessMaze();
+            else
+            {
+                DrawMaze();
+                DrawDecorations();
+                DrawPlayer();
+            }
             DrawHUD();
             pauseBtn.draw();
             DrawText(gamePaused ? "Play" : "Pause", (SCREEN_WIDTH - UI_PANEL_WIDTH) + 190, 20, 14, WHITE);
@@ -1571,9 +1918,28 @@ int main()
             DrawCenteredTextShadow("Press Q to stop", (SCREEN_WIDTH - UI_PANEL_WIDTH) / 2, 60, 14, DARKGRAY);
         }
 
+#ifndef MAZE_NO_PROFILER
+        if (showProfiler)
+            DrawProfilerOverlay();
+#endif
+        MAZE_PROFILE_LAP(frameProfiler, PHASE_DRAW);
+        MAZE_TRACE_END();
+        MAZE_TRACE_BEGIN("EndDrawing");
         EndDrawing();
+        MAZE_TRACE_END();
+        MAZE_PROFILE_LAP(frameProfiler, PHASE_PRESENT);
+        MAZE_PROFILE_END_FRAME(frameProfiler);
+        MAZE_TRACE_END();
     }
+#ifndef MAZE_NO_PROFILER
+    frameProfiler.writeCsv("frame-profile.csv");
+#endif
+    mazeSearch.cancel();
+    workerPool.reset();
+    traceStop();
     UnloadMusicStream(backgroundMusic);
+    if (mazeLayer.id != 0)
+        UnloadRenderTexture(mazeLayer);
     CloseAudioDevice();
 
     CloseWindow();
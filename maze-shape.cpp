@@ -0,0 +1,118 @@
+// Wall-nibble counting kernels behind countShape(). The kernel is chosen at
+// compile time: build with -mavx2 (or /arch:AVX2) for the 32-cell kernel;
+// every x86-64 build gets at least SSE2.
+#include "maze-core.h"
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MAZE_SHAPE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MAZE_SHAPE_SSE2 1
+#endif
+using namespace std;
+
+MazeShapeCounts countShapeScalar(const unsigned char *cells, size_t n)
+{
+    long long byOpen[5] = {0, 0, 0, 0, 0};
+    for (size_t i = 0; i < n; ++i)
+        byOpen[OPEN_SIDES[cells[i] & WALL_MASK]]++;
+    MazeShapeCounts c;
+    c.deadEnds = byOpen[1];
+    c.corridors = byOpen[2];
+    c.junctions = byOpen[3] + byOpen[4];
+    return c;
+}
+
+#if defined(MAZE_SHAPE_AVX2)
+// Wall counts come from a 16-entry popcount table via vpshufb. Matches are
+// summed as bytes (cmpeq gives -1, subtracted) for up to 255 steps, then
+// widened with vpsadbw before a byte counter can overflow.
+MazeShapeCounts countShape(const unsigned char *cells, size_t n)
+{
+    const __m256i popcount4 = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(WALL_MASK);
+    const __m256i two = _mm256_set1_epi8(2), three = _mm256_set1_epi8(3);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i deadSum = zero, corridorSum = zero, junctionSum = zero;
+    size_t i = 0;
+    while (n - i >= 32)
+    {
+        size_t steps = min<size_t>((n - i) / 32, 255);
+        __m256i dead = zero, corridor = zero, junction = zero;
+        for (size_t k = 0; k < steps; ++k, i += 32)
+        {
+            __m256i w = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(cells + i)), nibble);
+            __m256i walls = _mm256_shuffle_epi8(popcount4, w);
+            dead = _mm256_sub_epi8(dead, _mm256_cmpeq_epi8(walls, three));
+            corridor = _mm256_sub_epi8(corridor, _mm256_cmpeq_epi8(walls, two));
+            junction = _mm256_sub_epi8(junction, _mm256_cmpgt_epi8(two, walls));
+        }
+        deadSum = _mm256_add_epi64(deadSum, _mm256_sad_epu8(dead, zero));
+        corridorSum = _mm256_add_epi64(corridorSum, _mm256_sad_epu8(corridor, zero));
+        junctionSum = _mm256_add_epi64(junctionSum, _mm256_sad_epu8(junction, zero));
+    }
+    MazeShapeCounts c = countShapeScalar(cells + i, n - i);
+    long long lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), deadSum);
+    c.deadEnds += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), corridorSum);
+    c.corridors += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), junctionSum);
+    c.junctions += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return c;
+}
+
+const char *shapeKernelName() { return "avx2"; }
+
+#elif defined(MAZE_SHAPE_SSE2)
+// SSE2 has no byte shuffle, so the 4-bit popcount is done with the usual
+// pairwise adds. The 16-bit shifts only pull neighbouring-byte bits into
+// positions the masks clear.
+MazeShapeCounts countShape(const unsigned char *cells, size_t n)
+{
+    const __m128i nibble = _mm_set1_epi8(WALL_MASK);
+    const __m128i m5 = _mm_set1_epi8(0x05), m3 = _mm_set1_epi8(0x03);
+    const __m128i two = _mm_set1_epi8(2), three = _mm_set1_epi8(3);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i deadSum = zero, corridorSum = zero, junctionSum = zero;
+    size_t i = 0;
+    while (n - i >= 16)
+    {
+        size_t steps = min<size_t>((n - i) / 16, 255);
+        __m128i dead = zero, corridor = zero, junction = zero;
+        for (size_t k = 0; k < steps; ++k, i += 16)
+        {
+            __m128i w = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(cells + i)), nibble);
+            __m128i pairs = _mm_sub_epi8(w, _mm_and_si128(_mm_srli_epi16(w, 1), m5));
+            __m128i walls = _mm_add_epi8(_mm_and_si128(pairs, m3), _mm_and_si128(_mm_srli_epi16(pairs, 2), m3));
+            dead = _mm_sub_epi8(dead, _mm_cmpeq_epi8(walls, three));
+            corridor = _mm_sub_epi8(corridor, _mm_cmpeq_epi8(walls, two));
+            junction = _mm_sub_epi8(junction, _mm_cmplt_epi8(walls, two));
+        }
+        deadSum = _mm_add_epi64(deadSum, _mm_sad_epu8(dead, zero));
+        corridorSum = _mm_add_epi64(corridorSum, _mm_sad_epu8(corridor, zero));
+        junctionSum = _mm_add_epi64(junctionSum, _mm_sad_epu8(junction, zero));
+    }
+    MazeShapeCounts c = countShapeScalar(cells + i, n - i);
+    long long lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), deadSum);
+    c.deadEnds += lanes[0] + lanes[1];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), corridorSum);
+    c.corridors += lanes[0] + lanes[1];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), junctionSum);
+    c.junctions += lanes[0] + lanes[1];
+    return c;
+}
+
+const char *shapeKernelName() { return "sse2"; }
+
+#else
+MazeShapeCounts countShape(const unsigned char *cells, size_t n)
+{
+    return countShapeScalar(cells, n);
+}
+
+const char *shapeKernelName() { return "scalar"; }
+#endif
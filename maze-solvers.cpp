@@ -0,0 +1,526 @@
+#include "maze-solvers.h"
+#include "junction-graph.h"
+#include "trace-events.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+using namespace std;
+
+// neighbour of cell through side d, or -1 behind a wall / off the grid
+static int stepTo(const MazeGrid &grid, int cur, int d)
+{
+    int nx = grid.xOf(cur) + DIR_DX[d], ny = grid.yOf(cur) + DIR_DY[d];
+    if (grid.hasWall(cur, d) || !grid.inBounds(nx, ny))
+        return -1;
+    return grid.index(nx, ny);
+}
+
+// path from start to end by following parent links back from end
+static void tracePath(const MazeGrid &grid, const vector<int> &parent, int start, int end, vector<Coord> &path)
+{
+    int length = 1;
+    for (int cur = end; cur != start; cur = parent[cur])
+        length++;
+    path.resize(length);
+    for (int cur = end;; cur = parent[cur])
+    {
+        path[--length] = {grid.xOf(cur), grid.yOf(cur)};
+        if (cur == start)
+            break;
+    }
+}
+
+bool MazeSolver::solve(const MazeGrid &grid, int start, int goal, vector<Coord> &path, SolveStats *stats)
+{
+    MAZE_TRACE_SCOPE_DETAIL("solve", name(), -1);
+    path.clear();
+    if (grid.empty())
+        return false;
+    chrono::steady_clock::time_point t0;
+    if (stats)
+        t0 = chrono::steady_clock::now();
+    long long expanded = search(grid, start, goal, path);
+    if (stats)
+    {
+        stats->expanded = expanded;
+        stats->ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+    return !path.empty();
+}
+
+bool MazeSolver::solve(const MazeGrid &grid, vector<Coord> &path, SolveStats *stats)
+{
+    return solve(grid, 0, grid.size() - 1, path, stats);
+}
+
+// ---------- BFS ---------- //
+long long BfsSolver::search(const MazeGrid &grid, int start, int goal, vector<Coord> &path)
+{
+    if (static_cast<int>(parent.size()) != grid.size())
+        parent.assign(grid.size(), -1);
+    seen.begin(grid.size());
+    queue.clear();
+    queue.push(start);
+    seen.set(start);
+    long long expanded = 0;
+    while (!queue.empty())
+    {
+        int cur = queue.front();
+        queue.pop();
+        if (cur == goal)
+            break;
+        expanded++;
+        for (int d = 0; d < 4; ++d)
+        {
+            int next = stepTo(grid, cur, d);
+            if (next < 0 || seen.has(next))
+                continue;
+            seen.set(next);
+            parent[next] = cur;
+            queue.push(next);
+        }
+    }
+    if (seen.has(goal))
+        tracePath(grid, parent, start, goal, path);
+    return expanded;
+}
+
+size_t BfsSolver::memoryBytes() const
+{
+    return queue.poolBytes() + vectorBytes(parent) + seen.bytes();
+}
+
+// ---------- Bidirectional BFS ---------- //
+long long BidirectionalBfsSolver::search(const MazeGrid &grid, int start, int goal, vector<Coord> &path)
+{
+    if (start == goal)
+    {
+        path.assign(1, {grid.xOf(start), grid.yOf(start)});
+        return 0;
+    }
+    int ends[2] = {start, goal};
+    for (int s = 0; s < 2; ++s)
+    {
+        if (static_cast<int>(parent[s].size()) != grid.size())
+        {
+            parent[s].assign(grid.size(), -1);
+            dist[s].assign(grid.size(), 0);
+        }
+        seen[s].begin(grid.size());
+        seen[s].set(ends[s]);
+        dist[s][ends[s]] = 0;
+        frontier[s].clear();
+        frontier[s].push_back(ends[s]);
+    }
+
+    // best meeting edge: from[0] on the start side, from[1] on the goal side
+    long long expanded = 0;
+    int best = INT_MAX, meet[2] = {-1, -1};
+    while (!frontier[0].empty() && !frontier[1].empty())
+    {
+        int side = frontier[0].size() <= frontier[1].size() ? 0 : 1, other = 1 - side;
+        next.clear();
+        for (int cur : frontier[side])
+        {
+            expanded++;
+            for (int d = 0; d < 4; ++d)
+            {
+                int n = stepTo(grid, cur, d);
+                if (n < 0)
+                    continue;
+                if (seen[other].has(n) && dist[side][cur] + 1 + dist[other][n] < best)
+                {
+                    best = dist[side][cur] + 1 + dist[other][n];
+                    meet[side] = cur;
+                    meet[other] = n;
+                }
+                if (seen[side].has(n))
+                    continue;
+                seen[side].set(n);
+                parent[side][n] = cur;
+                dist[side][n] = dist[side][cur] + 1;
+                next.push_back(n);
+            }
+        }
+        frontier[side].swap(next);
+        // every path through a later level is at least as long
+        if (best != INT_MAX)
+            break;
+    }
+    if (best == INT_MAX)
+        return expanded;
+
+    tracePath(grid, parent[0], start, meet[0], path);
+    for (int cur = meet[1];; cur = parent[1][cur])
+    {
+        path.push_back({grid.xOf(cur), grid.yOf(cur)});
+        if (cur == goal)
+            break;
+    }
+    return expanded;
+}
+
+size_t BidirectionalBfsSolver::memoryBytes() const
+{
+    size_t bytes = vectorBytes(next);
+    for (int s = 0; s < 2; ++s)
+        bytes += vectorBytes(frontier[s]) + vectorBytes(parent[s]) + vectorBytes(dist[s]) + seen[s].bytes();
+    return bytes;
+}
+
+// ---------- A* ---------- //
+long long AStarSolver::search(const MazeGrid &grid, int start, int goal, vector<Coord> &path)
+{
+    if (static_cast<int>(parent.size()) != grid.size())
+    {
+        parent.assign(grid.size(), -1);
+        cost.assign(grid.size(), 0);
+    }
+    seen.begin(grid.size());
+    closed.begin(grid.size());
+    open.clear();
+    int gx = grid.xOf(goal), gy = grid.yOf(goal);
+    // Manhattan distance is consistent on a 4-connected grid, so the goal's
+    // first pop is optimal; ties go to the deeper entry to dive along corridors
+    auto later = [](const OpenEntry &a, const OpenEntry &b)
+    { return a.f != b.f ? a.f > b.f : a.g < b.g; };
+
+    seen.set(start);
+    cost[start] = 0;
+    open.push_back({abs(grid.xOf(start) - gx) + abs(grid.yOf(start) - gy), 0, start});
+    long long expanded = 0;
+    while (!open.empty())
+    {
+        pop_heap(open.begin(), open.end(), later);
+        OpenEntry top = open.back();
+        open.pop_back();
+        if (closed.has(top.cell))
+            continue;
+        closed.set(top.cell);
+        if (top.cell == goal)
+            break;
+        expanded++;
+        for (int d = 0; d < 4; ++d)
+        {
+            int n = stepTo(grid, top.cell, d);
+            if (n < 0 || closed.has(n))
+                continue;
+            int g = top.g + 1;
+            if (seen.has(n) && cost[n] <= g)
+                continue;
+            seen.set(n);
+            cost[n] = g;
+            parent[n] = top.cell;
+            open.push_back({g + abs(grid.xOf(n) - gx) + abs(grid.yOf(n) - gy), g, n});
+            push_heap(open.begin(), open.end(), later);
+        }
+    }
+    if (closed.has(goal))
+        tracePath(grid, parent, start, goal, path);
+    return expanded;
+}
+
+size_t AStarSolver::memoryBytes() const
+{
+    return vectorBytes(open) + vectorBytes(parent) + vectorBytes(cost) + seen.bytes() + closed.bytes();
+}
+
+// ---------- Bit-parallel BFS ---------- //
+static int popcount64(unsigned long long v)
+{
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((v * 0x0101010101010101ULL) >> 56);
+}
+
+// bit x % 64 of word y * wordsPerRow + x / 64 is cell (x, y); the last
+// column never opens right and the last row never opens down, so shifted
+// bits cannot leave the grid
+void BitParallelBfsSolver::buildPlanes(const MazeGrid &grid)
+{
+    int rows = grid.getRows(), cols = grid.getCols();
+    wordsPerRow = (cols + 63) / 64;
+    size_t words = static_cast<size_t>(rows) * wordsPerRow;
+    openRight.assign(words, 0);
+    openDown.assign(words, 0);
+    unsigned long long lastWord = cols % 64 ? (1ULL << (cols % 64 - 1)) - 1 : ~0ULL >> 1;
+    const unsigned char *cell = grid.bytes().data();
+    for (int y = 0; y < rows; ++y)
+    {
+        unsigned long long *right = &openRight[static_cast<size_t>(y) * wordsPerRow];
+        unsigned long long *down = &openDown[static_cast<size_t>(y) * wordsPerRow];
+        for (int w = 0; w < wordsPerRow; ++w)
+        {
+            // gather the wall bits of up to 64 cells, then invert
+            int n = min(64, cols - w * 64);
+            unsigned long long r = 0, d = 0;
+            for (int b = 0; b < n; ++b)
+            {
+                r |= static_cast<unsigned long long>((cell[b] >> DIR_RIGHT) & 1) << b;
+                d |= static_cast<unsigned long long>((cell[b] >> DIR_DOWN) & 1) << b;
+            }
+            cell += n;
+            unsigned long long valid = n == 64 ? ~0ULL : (1ULL << n) - 1;
+            right[w] = ~r & valid;
+            down[w] = ~d & valid;
+        }
+        right[wordsPerRow - 1] &= lastWord;
+        if (y == rows - 1)
+            fill(down, down + wordsPerRow, 0ULL);
+    }
+}
+
+// queues the unvisited cells of bits for the next level and records back,
+// the side that leads to the cell they were reached from; a word can appear
+// more than once in one level
+void BitParallelBfsSolver::mark(int word, unsigned long long bits, int back)
+{
+    unsigned long long fresh = bits & ~visited[word];
+    if (!fresh)
+        return;
+    visited[word] |= fresh;
+    if (back & 1)
+        backLow[word] |= fresh;
+    if (back & 2)
+        backHigh[word] |= fresh;
+    next.push_back({word, fresh});
+}
+
+long long BitParallelBfsSolver::search(const MazeGrid &grid, int start, int goal, vector<Coord> &path)
+{
+    if (start == goal)
+    {
+        path.assign(1, {grid.xOf(start), grid.yOf(start)});
+        return 0;
+    }
+    buildPlanes(grid);
+    int words = static_cast<int>(openRight.size());
+    auto wordOf = [&](int cell) { return grid.yOf(cell) * wordsPerRow + (grid.xOf(cell) >> 6); };
+    auto bitOf = [&](int cell) { return 1ULL << (grid.xOf(cell) & 63); };
+
+    visited.assign(words, 0);
+    backLow.assign(words, 0);
+    backHigh.assign(words, 0);
+    frontier.assign(1, {wordOf(start), bitOf(start)});
+    visited[wordOf(start)] = bitOf(start);
+
+    int goalWord = wordOf(goal);
+    unsigned long long goalBit = bitOf(goal);
+    long long expanded = 0;
+    bool found = false;
+    while (!found && !frontier.empty())
+    {
+        next.clear();
+        for (const FrontierWord &f : frontier)
+        {
+            int i = f.word;
+            unsigned long long bits = f.bits;
+            expanded += popcount64(bits);
+
+            // right: x -> x + 1, carrying bit 63 into the next word
+            unsigned long long m = bits & openRight[i];
+            mark(i, m << 1, DIR_LEFT);
+            if (m >> 63)
+                mark(i + 1, 1, DIR_LEFT);
+            // left: x + 1 -> x wherever x opens right, bit 0 carries back
+            mark(i, (bits >> 1) & openRight[i], DIR_RIGHT);
+            if ((bits & 1) && i % wordsPerRow && (openRight[i - 1] >> 63))
+                mark(i - 1, 1ULL << 63, DIR_RIGHT);
+            // down and up are the same word one row over
+            if (i + wordsPerRow < words)
+                mark(i + wordsPerRow, bits & openDown[i], DIR_UP);
+            if (i >= wordsPerRow)
+                mark(i - wordsPerRow, bits & openDown[i - wordsPerRow], DIR_DOWN);
+        }
+        frontier.swap(next);
+        found = (visited[goalWord] & goalBit) != 0;
+    }
+    if (!found)
+        return expanded;
+
+    // follow the recorded sides back from the goal, then reverse
+    for (int cur = goal;; )
+    {
+        path.push_back({grid.xOf(cur), grid.yOf(cur)});
+        if (cur == start)
+            break;
+        int w = wordOf(cur);
+        unsigned long long bit = bitOf(cur);
+        int d = ((backLow[w] & bit) ? 1 : 0) | ((backHigh[w] & bit) ? 2 : 0);
+        cur = grid.index(grid.xOf(cur) + DIR_DX[d], grid.yOf(cur) + DIR_DY[d]);
+    }
+    reverse(path.begin(), path.end());
+    return expanded;
+}
+
+size_t BitParallelBfsSolver::memoryBytes() const
+{
+    return vectorBytes(openRight) + vectorBytes(openDown) + vectorBytes(visited) + vectorBytes(backLow) +
+           vectorBytes(backHigh) + vectorBytes(frontier) + vectorBytes(next);
+}
+
+// ---------- Multi-threaded BFS ---------- //
+ParallelBfsSolver::ParallelBfsSolver(int threads) : pool(threads)
+{
+    next.resize(pool.threadCount());
+}
+
+// true for exactly one caller per cell; the plain load skips the atomic
+// read-modify-write for cells that are already taken
+bool ParallelBfsSolver::claim(int cell)
+{
+    atomic<unsigned long long> &word = visited[cell >> 6];
+    unsigned long long bit = 1ULL << (cell & 63);
+    if (word.load(memory_order_relaxed) & bit)
+        return false;
+    return !(word.fetch_or(bit, memory_order_relaxed) & bit);
+}
+
+void ParallelBfsSolver::expand(const MazeGrid &grid, const int *cells, int count, vector<int> &out)
+{
+    for (int k = 0; k < count; ++k)
+    {
+        int cur = cells[k];
+        for (int d = 0; d < 4; ++d)
+        {
+            int n = stepTo(grid, cur, d);
+            if (n >= 0 && claim(n))
+            {
+                parent[n] = cur;
+                out.push_back(n);
+            }
+        }
+    }
+}
+
+long long ParallelBfsSolver::search(const MazeGrid &grid, int start, int goal, vector<Coord> &path)
+{
+    size_t words = (static_cast<size_t>(grid.size()) + 63) / 64;
+    if (visitedWords != words)
+    {
+        visited.reset(new atomic<unsigned long long>[words]);
+        visitedWords = words;
+    }
+    for (size_t w = 0; w < words; ++w)
+        visited[w].store(0, memory_order_relaxed);
+    if (static_cast<int>(parent.size()) != grid.size())
+        parent.assign(grid.size(), -1);
+
+    frontier.assign(1, start);
+    claim(start);
+    wideLevels = 0;
+    long long expanded = 0;
+    int slices = static_cast<int>(next.size());
+    while (!frontier.empty() && !(visited[goal >> 6].load(memory_order_relaxed) >> (goal & 63) & 1))
+    {
+        int size = static_cast<int>(frontier.size());
+        expanded += size;
+        int used = min(slices, size / CELLS_PER_SLICE);
+        if (used <= 1)
+        {
+            next[0].clear();
+            expand(grid, frontier.data(), size, next[0]);
+            frontier.swap(next[0]);
+            continue;
+        }
+        wideLevels++;
+        // waitIdle() orders every worker's writes before the merge below
+        for (int t = 0; t < used; ++t)
+        {
+            int from = static_cast<int>(static_cast<long long>(size) * t / used);
+            int to = static_cast<int>(static_cast<long long>(size) * (t + 1) / used);
+            pool.submit([this, &grid, from, to, t]
+                        {
+                            next[t].clear();
+                            expand(grid, frontier.data() + from, to - from, next[t]); });
+        }
+        pool.waitIdle();
+        size_t total = 0;
+        for (int t = 0; t < used; ++t)
+            total += next[t].size();
+        frontier.clear();
+        frontier.reserve(total);
+        for (int t = 0; t < used; ++t)
+            frontier.insert(frontier.end(), next[t].begin(), next[t].end());
+    }
+    if (visited[goal >> 6].load(memory_order_relaxed) >> (goal & 63) & 1)
+        tracePath(grid, parent, start, goal, path);
+    return expanded;
+}
+
+size_t ParallelBfsSolver::memoryBytes() const
+{
+    size_t bytes = visitedWords * sizeof(unsigned long long) + vectorBytes(parent) + vectorBytes(frontier);
+    for (const vector<int> &n : next)
+        bytes += vectorBytes(n);
+    return bytes;
+}
+
+// ---------- Goal distance field ---------- //
+void DistanceField::build(const MazeGrid &grid, int goal)
+{
+    MAZE_TRACE_SCOPE("DistanceField::build");
+    int cells = grid.size();
+    cols = grid.getCols();
+    goalCell = goal;
+    dist.assign(cells, -1);
+    toward.assign(cells, NO_MOVE);
+    order.resize(cells);
+    if (cells == 0)
+        return;
+
+    // every reachable cell enters order exactly once, so it doubles as the queue
+    int head = 0, tail = 0;
+    order[tail++] = goal;
+    dist[goal] = 0;
+    while (head < tail)
+    {
+        int cur = order[head++];
+        for (int d = 0; d < 4; ++d)
+        {
+            int next = stepTo(grid, cur, d);
+            if (next < 0 || dist[next] >= 0)
+                continue;
+            dist[next] = dist[cur] + 1;
+            toward[next] = static_cast<unsigned char>(OppositeDir(d));
+            order[tail++] = next;
+        }
+    }
+}
+
+// ---------- Factory ---------- //
+unique_ptr<MazeSolver> makeSolver(SolverKind kind)
+{
+    if (kind == SOLVER_BIDIRECTIONAL)
+        return unique_ptr<MazeSolver>(new BidirectionalBfsSolver());
+    if (kind == SOLVER_ASTAR)
+        return unique_ptr<MazeSolver>(new AStarSolver());
+    if (kind == SOLVER_BIT_PARALLEL)
+        return unique_ptr<MazeSolver>(new BitParallelBfsSolver());
+    if (kind == SOLVER_PARALLEL)
+        return unique_ptr<MazeSolver>(new ParallelBfsSolver());
+    if (kind == SOLVER_JUNCTION)
+        return unique_ptr<MazeSolver>(new JunctionSolver());
+    return unique_ptr<MazeSolver>(new BfsSolver());
+}
+
+bool parseSolverKind(const string &name, SolverKind &kind)
+{
+    if (name == "bfs")
+        kind = SOLVER_BFS;
+    else if (name == "bidi")
+        kind = SOLVER_BIDIRECTIONAL;
+    else if (name == "astar")
+        kind = SOLVER_ASTAR;
+    else if (name == "bitbfs")
+        kind = SOLVER_BIT_PARALLEL;
+    else if (name == "parallel")
+        kind = SOLVER_PARALLEL;
+    else if (name == "junction")
+        kind = SOLVER_JUNCTION;
+    else
+        return false;
+    return true;
+}
@@ -0,0 +1,222 @@
+// Shortest-path solvers behind one interface: plain BFS (the game's
+// original solver), bidirectional BFS, A* with a Manhattan heuristic, a
+// bit-parallel BFS and a multi-threaded BFS for very large grids. The
+// junction-graph solver lives in junction-graph.h.
+// Every solver keeps its scratch buffers between calls, and per-cell marks
+// reset in O(1), so solving mazes of one size repeatedly does not allocate
+// or clear the whole grid.
+#pragma once
+
+#include "maze-core.h"
+#include "worker-pool.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Cells marked during the current solve. A cell is marked when its stamp
+// equals the current epoch, so begin() only touches memory when the grid
+// size changes or the epoch counter wraps.
+class EpochMarks
+{
+    std::vector<unsigned> stamp;
+    unsigned epoch = 0;
+
+public:
+    void begin(int cells)
+    {
+        if (static_cast<int>(stamp.size()) != cells)
+        {
+            stamp.assign(cells, 0);
+            epoch = 0;
+        }
+        if (++epoch == 0)
+        {
+            stamp.assign(stamp.size(), 0);
+            epoch = 1;
+        }
+    }
+    bool has(int i) const { return stamp[i] == epoch; }
+    void set(int i) { stamp[i] = epoch; }
+    size_t bytes() const { return stamp.capacity() * sizeof(unsigned); }
+};
+
+template <typename T>
+size_t vectorBytes(const std::vector<T> &v) { return v.capacity() * sizeof(T); }
+
+struct SolveStats
+{
+    long long expanded = 0; // cells taken off the frontier and expanded
+    double ms = 0;
+};
+
+class MazeSolver
+{
+public:
+    virtual ~MazeSolver() {}
+    virtual const char *name() const = 0;
+    // Scratch kept between solves. Buffers only grow, so this is the peak
+    // over every solve so far.
+    virtual size_t memoryBytes() const = 0;
+
+    // Shortest path between two cell indices, written into path (empty when
+    // goal cannot be reached). Returns whether a path was found.
+    bool solve(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path, SolveStats *stats = nullptr);
+    // (0,0) to the bottom-right cell
+    bool solve(const MazeGrid &grid, std::vector<Coord> &path, SolveStats *stats = nullptr);
+
+protected:
+    // fills or clears path and returns the number of cells expanded
+    virtual long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) = 0;
+};
+
+class BfsSolver : public MazeSolver
+{
+    Queue<int> queue;
+    std::vector<int> parent;
+    EpochMarks seen;
+
+public:
+    const char *name() const override { return "bfs"; }
+    size_t memoryBytes() const override;
+
+protected:
+    long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) override;
+};
+
+// Grows a BFS ball from each end, one whole level at a time and always on
+// the smaller frontier, and joins them at the first level where they touch.
+class BidirectionalBfsSolver : public MazeSolver
+{
+    std::vector<int> frontier[2], next;
+    std::vector<int> parent[2], dist[2];
+    EpochMarks seen[2];
+
+public:
+    const char *name() const override { return "bidi"; }
+    size_t memoryBytes() const override;
+
+protected:
+    long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) override;
+};
+
+class AStarSolver : public MazeSolver
+{
+    struct OpenEntry
+    {
+        int f, g, cell;
+    };
+    std::vector<OpenEntry> open; // binary heap
+    std::vector<int> parent, cost;
+    EpochMarks seen, closed;
+
+public:
+    const char *name() const override { return "astar"; }
+    size_t memoryBytes() const override;
+
+protected:
+    long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) override;
+};
+
+// BFS on 64-cell words. The open sides of the grid are first packed into two
+// bitplanes (open to the right, open downward); each level then advances
+// the frontier a whole word at a time with shifts masked by those planes.
+// Only words holding frontier cells are touched. Instead of parent links,
+// two more bitplanes keep the side each cell was reached from, so the
+// scratch is five bits per cell plus the current and next frontier.
+class BitParallelBfsSolver : public MazeSolver
+{
+    struct FrontierWord
+    {
+        int word;
+        unsigned long long bits;
+    };
+    int wordsPerRow = 0;
+    std::vector<unsigned long long> openRight, openDown, visited;
+    std::vector<unsigned long long> backLow, backHigh; // 2-bit side back toward the parent
+    std::vector<FrontierWord> frontier, next;
+
+    void buildPlanes(const MazeGrid &grid);
+    void mark(int word, unsigned long long bits, int back);
+
+public:
+    const char *name() const override { return "bitbfs"; }
+    size_t memoryBytes() const override;
+
+protected:
+    long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) override;
+};
+
+// Level-synchronous BFS on a worker pool. Each level's frontier is cut into
+// one slice per worker; a cell goes to whichever worker first sets its bit in
+// the shared visited bitmap, so every cell is claimed and gets its parent
+// written exactly once. Levels smaller than two slices' worth of cells are
+// expanded on the calling thread, since waking the pool costs more than
+// expanding them; in perfect mazes that is most levels.
+class ParallelBfsSolver : public MazeSolver
+{
+    WorkerPool pool;
+    std::unique_ptr<std::atomic<unsigned long long>[]> visited;
+    size_t visitedWords = 0;
+    std::vector<int> parent, frontier;
+    std::vector<std::vector<int>> next; // one per slice
+    long long wideLevels = 0;
+
+    bool claim(int cell);
+    void expand(const MazeGrid &grid, const int *cells, int count, std::vector<int> &out);
+
+public:
+    static constexpr int CELLS_PER_SLICE = 256;
+
+    // threads <= 0 uses one thread per hardware core
+    explicit ParallelBfsSolver(int threads = 0);
+    const char *name() const override { return "parallel"; }
+    size_t memoryBytes() const override;
+    int threadCount() const { return pool.threadCount(); }
+    // levels of the last solve that were big enough to split across workers
+    long long lastWideLevels() const { return wideLevels; }
+
+protected:
+    long long search(const MazeGrid &grid, int start, int goal, std::vector<Coord> &path) override;
+};
+
+// Distance from every cell to one goal, built by a single reverse BFS when
+// a maze is loaded. After that "how far to the goal" and "which way is
+// shorter" are O(1) array reads for any cell, with no further searching.
+class DistanceField
+{
+    std::vector<int> dist;            // -1 where the goal cannot be reached
+    std::vector<unsigned char> toward; // side leading one step closer
+    std::vector<int> order;           // BFS queue, reused between builds
+    int cols = 0, goalCell = -1;
+
+public:
+    static constexpr unsigned char NO_MOVE = 0xFF;
+
+    void build(const MazeGrid &grid, int goal);
+    // goal is the bottom-right cell, as in the game
+    void build(const MazeGrid &grid) { build(grid, grid.size() - 1); }
+    bool empty() const { return dist.empty(); }
+    int goal() const { return goalCell; }
+
+    int distance(int cell) const { return dist[cell]; }
+    int distance(int x, int y) const { return dist[y * cols + x]; }
+    // UP/DOWN/LEFT/RIGHT toward the goal, or NO_MOVE at the goal itself and
+    // on cells that cannot reach it
+    unsigned char bestMove(int x, int y) const { return toward[y * cols + x]; }
+};
+
+enum SolverKind
+{
+    SOLVER_BFS,
+    SOLVER_BIDIRECTIONAL,
+    SOLVER_ASTAR,
+    SOLVER_BIT_PARALLEL,
+    SOLVER_PARALLEL,
+    SOLVER_JUNCTION
+};
+const int SOLVER_KIND_COUNT = 6;
+
+std::unique_ptr<MazeSolver> makeSolver(SolverKind kind);
+// "bfs", "bidi", "astar", "bitbfs", "parallel" or "junction"
+bool parseSolverKind(const std::string &name, SolverKind &kind);
@@ -0,0 +1,1081 @@
+// mazegen - headless batch generator / solver / scorer built on maze-core.
+//
+//   mazegen [batch] [--size N | --rows R --cols C] [--seed S] [--count N] [--verbose]
+//   mazegen pick [--difficulty easy|medium|hard] [--candidates N] [--threads N] [--rejection] ...
+//   mazegen target [--difficulty D] [--size N] [--count N] [--seed S]
+//   mazegen bench-gen [--min-size N] [--max-size N] [--seed S]
+//   mazegen bench-score [--size N] [--count N] [--algo A] [--seed S]
+//   mazegen bench-solve [--size N] [--count N] [--algo A] [--seed S]
+//   mazegen bench-parallel [--size N] [--count N] [--algo A] [--threads MAX]
+//   mazegen bench-dynamic [--size N] [--count SECONDS] [--walls N] [--seed S]
+//   mazegen bench-mesh [--size N] [--count N] [--algo A] [--seed S]
+//   mazegen stream --rows R --cols C [--seed S] [--out FILE]
+//   mazegen endless [--count STEPS] [--seed S]
+//   mazegen alloc [--size N] [--count N] [--seed S]
+//   mazegen show [--size N] --seed S [--algo A | --difficulty D]
+//
+// Seeds are 16 hex digits, the same form the game shows in its HUD. Every
+// maze is built from its own seed: batch maze i uses deriveSeed(S, i), and
+// show rebuilds exactly the maze with seed S (e.g. one seen in the game).
+// Game codes such as H-0123456789ABCDEF are difficulty-targeted mazes; the
+// prefix is accepted by --seed and means --difficulty hard.
+// batch generates --count mazes, solves and scores each one and reports how
+// long every phase took together with the overall throughput in mazes per
+// second. pick runs the game's concurrent candidate search --count times,
+// targeted by default or by rejection sampling with --rejection. target
+// reports how many attempts and how long generateForDifficulty needs per
+// maze for each band (or just --difficulty).
+// bench-gen times generateFullMaze on square mazes of doubling size; with
+// linear scaling the ns/cell column stays flat. bench-score scores --count
+// mazes with the scalar and the SIMD shape kernel and checks they agree.
+// bench-solve runs every MazeSolver on the same mazes, checks that each
+// returns a valid shortest path and reports cells expanded and time. It
+// also builds the goal distance field and follows its best moves from the
+// start, which must take exactly the shortest path length, and times the
+// junction graph's build, route and expand steps separately, checking that
+// its node counts give evaluateDifficulty's exact score. bench-parallel
+// solves the same mazes with the multi-threaded BFS at 1, 2, 4, ... --threads
+// workers (default 32) and reports the speedup over one worker and over the
+// plain BFS; every path length must match. bench-dynamic plays --count
+// seconds of 60 FPS frames on a maze with --walls shifting walls while a
+// walker follows the path; D* Lite repairs the path every frame and each
+// frame's length is checked against a fresh BFS. bench-mesh builds the
+// merged wall mesh for --count mazes, checks that its runs cover every wall
+// edge exactly once and compares its quad and vertex counts with drawing
+// every wall of every cell. stream runs Eller's
+// algorithm row by row, so --rows can be in the millions while memory stays
+// O(cols); rows go to --out (MZR1 file: "MZR1", int32 rows, int32 cols, then
+// one MazeGrid byte per cell) or are only counted. endless flies a window
+// across the chunked endless world and checks that memory stays bounded,
+// chunk borders agree and revisited chunks come back identical. alloc counts
+// global-heap allocations (operator new is replaced in this binary) and pool
+// slab allocations per maze once the containers are warmed up. --trace
+// writes a Chrome trace of any command (generation, scoring, candidates on
+// their worker threads, solving) for chrome://tracing or Perfetto. batch and
+// show print a digest of the wall bits, which must not change between builds
+// or platforms for the same seed.
+
+#include "maze-core.h"
+#include "candidate-search.h"
+#include "chunked-maze.h"
+#include "maze-solvers.h"
+#include "junction-graph.h"
+#include "dynamic-maze.h"
+#include "wall-mesh.h"
+#include "trace-events.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+// ---------- heap accounting (this binary only) ---------- //
+static atomic<long long> heapAllocations(0);
+
+void *operator new(size_t n)
+{
+    ++heapAllocations;
+    if (void *p = malloc(n ? n : 1))
+        return p;
+    throw bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+struct CliOptions
+{
+    string command = "batch";
+    int rows = 40, cols = 40;
+    unsigned long long seed = 0;
+    bool seedGiven = false;
+    int count = 100;
+    bool verbose = false;
+    DifficultyLevel difficulty = DIFF_HARD;
+    bool difficultyGiven = false;
+    bool rejection = false;
+    int candidates = 6;
+    int threads = 0;
+    int minSize = 20, maxSize = 8192;
+    int warmup = 1;
+    int walls = 0;
+    MazeAlgorithm algorithm = ALGO_BACKTRACKER;
+    bool check = false;
+    string outPath;
+    string tracePath;
+};
+
+static double msSince(Clock::time_point t0)
+{
+    return chrono::duration<double, milli>(Clock::now() - t0).count();
+}
+
+static void printUsage()
+{
+    printf("usage: mazegen [batch|pick|target|bench-gen|bench-score|bench-solve|bench-parallel|bench-dynamic|bench-mesh|stream|endless|alloc|show] [options]\n"
+           "  --size N          square maze of N x N cells (default 40)\n"
+           "  --rows R --cols C rectangular maze\n"
+           "  --seed S          64-bit seed in hex (default: clock)\n"
+           "  --count N         number of mazes to generate (default 100)\n"
+           "  --verbose         print one line per maze\n"
+           "  --algo A          dfs (default) or eller\n"
+           "  --check           verify every maze is perfect and that the score kept\n"
+           "                    during generation matches evaluateDifficulty (batch, target)\n"
+           "  --trace FILE      write a Chrome trace_event JSON of the run (any command)\n"
+           "pick options:\n"
+           "  --difficulty D    easy, medium or hard (default hard)\n"
+           "  --candidates N    candidates per search (default 6)\n"
+           "  --threads N       worker threads (default: one per core;\n"
+           "                    bench-parallel: largest count to try, default 32)\n"
+           "  --rejection       keep random --algo mazes that land in the band\n"
+           "                    instead of steering toward it\n"
+           "bench-gen options:\n"
+           "  --min-size N      first size, doubled each step (default 20)\n"
+           "  --max-size N      last size (default 8192)\n"
+           "bench-dynamic options:\n"
+           "  --count N         simulated seconds at 60 FPS (default 100)\n"
+           "  --walls N         shifting walls (default: one per 400 cells, at least 8)\n"
+           "alloc options:\n"
+           "  --warmup N        uncounted mazes before measuring (default 1)\n"
+           "stream options:\n"
+           "  --out FILE        write the rows to an MZR1 file\n"
+           "show options:\n"
+           "  --verbose         draw the maze as ASCII\n"
+           "  --difficulty D    rebuild a difficulty-targeted maze (E-/M-/H- codes)\n");
+}
+
+// returns false (after printing why) when the arguments are unusable
+static bool parseArgs(int argc, char **argv, CliOptions &opt)
+{
+    int i = 1;
+    if (i < argc && argv[i][0] != '-')
+        opt.command = argv[i++];
+    for (; i < argc; ++i)
+    {
+        string a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (a == "--size" && hasValue)
+            opt.rows = opt.cols = atoi(argv[++i]);
+        else if (a == "--rows" && hasValue)
+            opt.rows = atoi(argv[++i]);
+        else if (a == "--cols" && hasValue)
+            opt.cols = atoi(argv[++i]);
+        else if (a == "--seed" && hasValue)
+        {
+            string text = argv[++i];
+            if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X'))
+                text = text.substr(2);
+            else if (text.size() > 2 && text[1] == '-' && (text[0] == 'E' || text[0] == 'M' || text[0] == 'H'))
+            {
+                opt.difficulty = text[0] == 'E' ? DIFF_EASY : (text[0] == 'M' ? DIFF_MEDIUM : DIFF_HARD);
+                opt.difficultyGiven = true;
+                text = text.substr(2);
+            }
+            if (!parseSeed(text, opt.seed))
+            {
+                fprintf(stderr, "mazegen: seed must be 1-16 hex digits, got '%s'\n", argv[i]);
+                return false;
+            }
+            opt.seedGiven = true;
+        }
+        else if (a == "--count" && hasValue)
+            opt.count = atoi(argv[++i]);
+        else if (a == "--difficulty" && hasValue)
+        {
+            string d = argv[++i];
+            if (d == "easy")
+                opt.difficulty = DIFF_EASY;
+            else if (d == "medium")
+                opt.difficulty = DIFF_MEDIUM;
+            else if (d == "hard")
+                opt.difficulty = DIFF_HARD;
+            else
+            {
+                fprintf(stderr, "mazegen: unknown difficulty '%s'\n", d.c_str());
+                return false;
+            }
+            opt.difficultyGiven = true;
+        }
+        else if (a == "--candidates" && hasValue)
+            opt.candidates = atoi(argv[++i]);
+        else if (a == "--threads" && hasValue)
+            opt.threads = atoi(argv[++i]);
+        else if (a == "--min-size" && hasValue)
+            opt.minSize = atoi(argv[++i]);
+        else if (a == "--max-size" && hasValue)
+            opt.maxSize = atoi(argv[++i]);
+        else if (a == "--algo" && hasValue)
+        {
+            string algo = argv[++i];
+            if (algo == "dfs")
+                opt.algorithm = ALGO_BACKTRACKER;
+            else if (algo == "eller")
+                opt.algorithm = ALGO_ELLER;
+            else
+            {
+                fprintf(stderr, "mazegen: unknown algorithm '%s'\n", algo.c_str());
+                return false;
+            }
+        }
+        else if (a == "--rejection")
+            opt.rejection = true;
+        else if (a == "--check")
+            opt.check = true;
+        else if (a == "--walls" && hasValue)
+            opt.walls = atoi(argv[++i]);
+        else if (a == "--warmup" && hasValue)
+            opt.warmup = atoi(argv[++i]);
+        else if (a == "--out" && hasValue)
+            opt.outPath = argv[++i];
+        else if (a == "--trace" && hasValue)
+            opt.tracePath = argv[++i];
+        else if (a == "--verbose")
+            opt.verbose = true;
+        else if (a == "--help" || a == "-h")
+            return false;
+        else
+        {
+            fprintf(stderr, "mazegen: unknown or incomplete option '%s'\n", a.c_str());
+            return false;
+        }
+    }
+    if (opt.rows <= 0 || opt.cols <= 0 || opt.count <= 0 || opt.warmup < 0 || opt.candidates <= 0 || opt.minSize <= 0 || opt.maxSize < opt.minSize)
+    {
+        fprintf(stderr, "mazegen: size and count must be positive\n");
+        return false;
+    }
+    if (!opt.seedGiven)
+        opt.seed = mixSeed(static_cast<unsigned long long>(chrono::system_clock::now().time_since_epoch().count()));
+    return true;
+}
+
+// ---------- batch: generate + solve + score ---------- //
+static int runBatch(const CliOptions &opt)
+{
+    MazeGrid grid;
+    double genMs = 0, solveMs = 0, scoreMs = 0;
+    double scoreSum = 0;
+    long long pathSum = 0;
+    int broken = 0;
+    unsigned long long digest = 0;
+    int scoreMismatches = 0;
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < opt.count; ++i)
+    {
+        unsigned long long seed = deriveSeed(opt.seed, static_cast<unsigned long long>(i));
+        MazeMetrics shape;
+        Clock::time_point t0 = Clock::now();
+        generateMaze(grid, opt.rows, opt.cols, seed, opt.algorithm, &shape);
+        genMs += msSince(t0);
+        digest = mixSeed(digest ^ mazeDigest(grid));
+        if (opt.check && !isPerfectMaze(grid))
+        {
+            broken++;
+            fprintf(stderr, "maze %d is not a perfect maze\n", i);
+        }
+
+        t0 = Clock::now();
+        vector<Coord> path = BFSSolve(grid);
+        solveMs += msSince(t0);
+
+        // counts come from generation; only the final arithmetic is left
+        t0 = Clock::now();
+        float score = difficultyScore(opt.rows, opt.cols, shape);
+        scoreMs += msSince(t0);
+        if (opt.check)
+        {
+            float full = evaluateDifficulty(grid);
+            if (memcmp(&full, &score, sizeof(float)) != 0)
+            {
+                scoreMismatches++;
+                fprintf(stderr, "maze %d: fused score %.9g, full pass %.9g\n", i, score, full);
+            }
+        }
+
+        scoreSum += score;
+        pathSum += static_cast<long long>(path.size());
+        if (opt.verbose)
+            printf("maze %d: seed %s, score %.2f, path %zu cells\n", i, formatSeed(seed).c_str(), score, path.size());
+    }
+    double totalMs = msSince(start);
+
+    printf("mazegen: %d %s mazes of %dx%d, seed %s\n", opt.count, opt.algorithm == ALGO_ELLER ? "eller" : "dfs", opt.cols, opt.rows, formatSeed(opt.seed).c_str());
+    printf("  generate  %10.2f ms\n", genMs);
+    printf("  solve     %10.2f ms\n", solveMs);
+    printf("  score     %10.2f ms\n", scoreMs);
+    printf("  total     %10.2f ms  (%.1f mazes/s)\n", totalMs, opt.count / (totalMs / 1000.0));
+    printf("  avg score %.2f, avg path length %.1f cells\n", scoreSum / opt.count, static_cast<double>(pathSum) / opt.count);
+    if (opt.check)
+    {
+        printf("  perfect   %d/%d\n", opt.count - broken, opt.count);
+        printf("  fused score bit-identical %d/%d\n", opt.count - scoreMismatches, opt.count);
+    }
+    printf("  digest    %s\n", formatSeed(digest).c_str());
+    return broken || scoreMismatches ? 1 : 0;
+}
+
+// ---------- pick: concurrent candidate search ---------- //
+static int runPick(const CliOptions &opt)
+{
+    WorkerPool pool(opt.threads);
+    CandidateSearchParams p;
+    p.rows = opt.rows;
+    p.cols = opt.cols;
+    p.candidates = opt.candidates;
+    p.algorithm = opt.algorithm;
+    p.targeted = !opt.rejection;
+    difficultyBand(opt.difficulty, p.minScore, p.maxScore);
+
+    int inBand = 0;
+    long long built = 0, attempts = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < opt.count; ++i)
+    {
+        p.baseSeed = deriveSeed(opt.seed, static_cast<unsigned long long>(i));
+        CandidateSearch search;
+        search.start(pool, p);
+        pool.waitIdle();
+        MazeDifficulty md;
+        vector<MazeDifficulty> all;
+        CandidateSearchReport report;
+        search.take(md, &all, &report);
+        built += report.built;
+        attempts += report.attempts;
+        bool hit = md.score >= p.minScore && md.score <= p.maxScore;
+        inBand += hit ? 1 : 0;
+        if (opt.verbose)
+            printf("search %d: picked candidate %d (seed %s), score %.2f (%s), %d built, %d attempts, %.2f ms\n", i, md.id,
+                   formatSeed(md.seed).c_str(), md.score, hit ? "in band" : "outside band", report.built, report.attempts, report.ms);
+    }
+    double totalMs = msSince(start);
+
+    printf("mazegen pick: %d %s searches of up to %d candidates, %dx%d, %d threads, seed %s\n", opt.count,
+           p.targeted ? "targeted" : "rejection", opt.candidates, opt.cols, opt.rows, pool.threadCount(), formatSeed(opt.seed).c_str());
+    printf("  band %.0f-%.0f hit %d/%d, %lld candidates built, %lld mazes generated\n", p.minScore, p.maxScore, inBand, opt.count, built, attempts);
+    printf("  total     %10.2f ms  (%.2f ms per search)\n", totalMs, totalMs / opt.count);
+    return 0;
+}
+
+// ---------- target: difficulty-targeted generation ---------- //
+static int runTarget(const CliOptions &opt)
+{
+    printf("mazegen target: %d mazes of %dx%d per band, seed %s\n", opt.count, opt.cols, opt.rows, formatSeed(opt.seed).c_str());
+    printf("  %-7s %8s %9s %9s %10s %10s %9s\n", "band", "in band", "avg tries", "max tries", "avg ms", "max ms", "avg score");
+    const char *names[3] = {"easy", "medium", "hard"};
+    MazeGrid grid;
+    int missed = 0;
+    for (int level = DIFF_EASY; level <= DIFF_HARD; ++level)
+    {
+        if (opt.difficultyGiven && level != opt.difficulty)
+            continue;
+        float lo, hi;
+        difficultyBand(static_cast<DifficultyLevel>(level), lo, hi);
+        int hits = 0, maxTries = 0;
+        long long tries = 0;
+        double ms = 0, maxMs = 0, scoreSum = 0;
+        for (int i = 0; i < opt.count; ++i)
+        {
+            TargetReport rep;
+            unsigned long long seed = deriveSeed(opt.seed, static_cast<unsigned long long>(i));
+            hits += generateForDifficulty(grid, opt.rows, opt.cols, seed, lo, hi, &rep) ? 1 : 0;
+            float full = opt.check ? evaluateDifficulty(grid) : rep.score;
+            if (memcmp(&full, &rep.score, sizeof(float)) != 0)
+            {
+                missed++;
+                fprintf(stderr, "%s %d: fused score %.9g, full pass %.9g\n", names[level], i, rep.score, full);
+            }
+            tries += rep.attempts;
+            maxTries = max(maxTries, rep.attempts);
+            ms += rep.ms;
+            maxMs = max(maxMs, rep.ms);
+            scoreSum += rep.score;
+            if (opt.verbose)
+                printf("  %s %d: seed %s, %d tries, bias %.3f, score %.2f, %.3f ms\n", names[level], i, formatSeed(seed).c_str(),
+                       rep.attempts, rep.bias, rep.score, rep.ms);
+        }
+        missed += opt.count - hits;
+        printf("  %-7s %4d/%-4d %9.2f %9d %10.3f %10.3f %9.2f\n", names[level], hits, opt.count, static_cast<double>(tries) / opt.count,
+               maxTries, ms / opt.count, maxMs, scoreSum / opt.count);
+    }
+    return missed ? 1 : 0;
+}
+
+// ---------- bench-gen: generation scaling ---------- //
+static int runBenchGen(const CliOptions &opt)
+{
+    printf("mazegen bench-gen: seed %s\n", formatSeed(opt.seed).c_str());
+    printf("  %6s %12s %6s %12s %10s\n", "size", "cells", "reps", "ms/maze", "ns/cell");
+    MazeGrid grid;
+    for (int size = opt.minSize;; size = min(size * 2, opt.maxSize))
+    {
+        long long cells = static_cast<long long>(size) * size;
+        // repeat small mazes so every row measures at least ~4M cells of work
+        int reps = static_cast<int>(max(1LL, 4000000LL / cells));
+        Clock::time_point t0 = Clock::now();
+        for (int r = 0; r < reps; ++r)
+            generateFullMaze(grid, size, size, deriveSeed(opt.seed, static_cast<unsigned long long>(r)));
+        double ms = msSince(t0) / reps;
+        printf("  %6d %12lld %6d %12.3f %10.1f\n", size, cells, reps, ms, ms * 1e6 / cells);
+        fflush(stdout);
+        if (size == opt.maxSize)
+            break;
+    }
+    return 0;
+}
+
+// ---------- bench-score: shape kernels ---------- //
+static int runBenchScore(const CliOptions &opt)
+{
+    // a few distinct mazes scored round-robin, so the timing is not one
+    // grid sitting in L1
+    const int distinct = 16;
+    vector<MazeGrid> mazes(distinct);
+    for (int k = 0; k < distinct; ++k)
+        generateMaze(mazes[k], opt.rows, opt.cols, deriveSeed(opt.seed, static_cast<unsigned long long>(k)), opt.algorithm);
+
+    long long sink = 0;
+    int mismatches = 0;
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < opt.count; ++i)
+    {
+        const vector<unsigned char> &b = mazes[i % distinct].bytes();
+        MazeShapeCounts c = countShapeScalar(b.data(), b.size());
+        sink += c.deadEnds + c.corridors + c.junctions;
+    }
+    double scalarMs = msSince(t0);
+
+    t0 = Clock::now();
+    for (int i = 0; i < opt.count; ++i)
+    {
+        const vector<unsigned char> &b = mazes[i % distinct].bytes();
+        MazeShapeCounts c = countShape(b.data(), b.size());
+        sink -= c.deadEnds + c.corridors + c.junctions;
+    }
+    double kernelMs = msSince(t0);
+
+    double scoreSum = 0;
+    t0 = Clock::now();
+    for (int i = 0; i < opt.count; ++i)
+        scoreSum += evaluateDifficulty(mazes[i % distinct]);
+    double evalMs = msSince(t0);
+
+    for (int k = 0; k < distinct; ++k)
+    {
+        const vector<unsigned char> &b = mazes[k].bytes();
+        MazeShapeCounts a = countShapeScalar(b.data(), b.size()), v = countShape(b.data(), b.size());
+        if (a.deadEnds != v.deadEnds || a.corridors != v.corridors || a.junctions != v.junctions)
+        {
+            mismatches++;
+            fprintf(stderr, "maze %d: scalar %lld/%lld/%lld, %s %lld/%lld/%lld\n", k, a.deadEnds, a.corridors, a.junctions,
+                    shapeKernelName(), v.deadEnds, v.corridors, v.junctions);
+        }
+    }
+
+    double cells = static_cast<double>(opt.rows) * opt.cols * opt.count;
+    printf("mazegen bench-score: %d scores of %dx%d mazes, kernel %s, seed %s\n", opt.count, opt.cols, opt.rows, shapeKernelName(),
+           formatSeed(opt.seed).c_str());
+    printf("  %-20s %10s %10s %12s\n", "", "ms", "ns/cell", "Mcells/s");
+    printf("  %-20s %10.2f %10.3f %12.1f\n", "scalar lookup", scalarMs, scalarMs * 1e6 / cells, cells / scalarMs / 1000.0);
+    printf("  %-20s %10.2f %10.3f %12.1f\n", shapeKernelName(), kernelMs, kernelMs * 1e6 / cells, cells / kernelMs / 1000.0);
+    printf("  %-20s %10.2f %10.3f %12.1f\n", "evaluateDifficulty", evalMs, evalMs * 1e6 / cells, cells / evalMs / 1000.0);
+    printf("  speedup %.2fx, kernels agree on %d/%d mazes (avg score %.2f%s)\n", scalarMs / kernelMs, distinct - mismatches, distinct,
+           scoreSum / opt.count, sink ? ", checksum differs" : "");
+    return mismatches || sink ? 1 : 0;
+}
+
+// ---------- bench-solve: solver comparison ---------- //
+// true when path walks from (0,0) to the goal through open walls only
+static bool isValidPath(const MazeGrid &grid, const vector<Coord> &path)
+{
+    if (path.empty() || path.front().x != 0 || path.front().y != 0)
+        return false;
+    if (path.back().x != grid.getCols() - 1 || path.back().y != grid.getRows() - 1)
+        return false;
+    for (size_t k = 1; k < path.size(); ++k)
+    {
+        int d = 0;
+        while (d < 4 && (path[k - 1].x + DIR_DX[d] != path[k].x || path[k - 1].y + DIR_DY[d] != path[k].y))
+            d++;
+        if (d == 4 || grid.hasWall(path[k - 1].x, path[k - 1].y, d))
+            return false;
+    }
+    return true;
+}
+
+static int runBenchSolve(const CliOptions &opt)
+{
+    unique_ptr<MazeSolver> solvers[SOLVER_KIND_COUNT];
+    long long expanded[SOLVER_KIND_COUNT] = {};
+    double ms[SOLVER_KIND_COUNT] = {};
+    int bad[SOLVER_KIND_COUNT] = {};
+    for (int k = 0; k < SOLVER_KIND_COUNT; ++k)
+        solvers[k] = makeSolver(static_cast<SolverKind>(k));
+
+    MazeGrid grid;
+    vector<Coord> path;
+    DistanceField field;
+    double fieldMs = 0;
+    int fieldBad = 0;
+    JunctionGraph graph;
+    double graphMs[3] = {0, 0, 0}; // build, route, expand
+    long long graphNodes = 0, graphEdges = 0, routeExpanded = 0;
+    int graphBad = 0;
+    long long pathSum = 0;
+    long long repeatExpanded = 0; // junction solver asked again on the same maze
+    double repeatMs = 0;
+    int repeatBad = 0;
+    for (int i = 0; i < opt.count; ++i)
+    {
+        generateMaze(grid, opt.rows, opt.cols, deriveSeed(opt.seed, static_cast<unsigned long long>(i)), opt.algorithm);
+        size_t shortest = 0;
+        for (int k = 0; k < SOLVER_KIND_COUNT; ++k)
+        {
+            SolveStats stats;
+            solvers[k]->solve(grid, path, &stats);
+            expanded[k] += stats.expanded;
+            ms[k] += stats.ms;
+            if (k == 0)
+                shortest = path.size();
+            if (!isValidPath(grid, path) || path.size() != shortest)
+            {
+                bad[k]++;
+                fprintf(stderr, "maze %d: %s returned %zu cells, bfs %zu\n", i, solvers[k]->name(), path.size(), shortest);
+            }
+        }
+        pathSum += static_cast<long long>(shortest);
+        SolveStats again;
+        solvers[SOLVER_JUNCTION]->solve(grid, path, &again);
+        repeatExpanded += again.expanded;
+        repeatMs += again.ms;
+        if (!isValidPath(grid, path) || path.size() != shortest)
+            repeatBad++;
+
+        Clock::time_point t0 = Clock::now();
+        field.build(grid);
+        fieldMs += msSince(t0);
+        int x = 0, y = 0, steps = 0;
+        for (int d; (d = field.bestMove(x, y)) != DistanceField::NO_MOVE && steps <= grid.size(); ++steps)
+        {
+            x += DIR_DX[d];
+            y += DIR_DY[d];
+        }
+        if (field.distance(0, 0) != static_cast<int>(shortest) - 1 || steps != field.distance(0, 0) || grid.index(x, y) != field.goal())
+        {
+            fieldBad++;
+            fprintf(stderr, "maze %d: distance field gives %d steps, bfs %zu cells\n", i, field.distance(0, 0), shortest);
+        }
+
+        t0 = Clock::now();
+        graph.build(grid);
+        graphMs[0] += msSince(t0);
+        t0 = Clock::now();
+        long long nodesExpanded = 0;
+        int length = graph.shortestRoute(graph.nodeAt(0), graph.nodeAt(grid.size() - 1), &nodesExpanded);
+        graphMs[1] += msSince(t0);
+        t0 = Clock::now();
+        graph.expandRoute(grid, path);
+        graphMs[2] += msSince(t0);
+        graphNodes += graph.nodeCount();
+        graphEdges += graph.edgeCount();
+        routeExpanded += nodesExpanded;
+        if (length != static_cast<int>(shortest) - 1 || path.size() != shortest || graph.difficulty() != evaluateDifficulty(grid))
+        {
+            graphBad++;
+            fprintf(stderr, "maze %d: junction route %d steps, bfs %zu cells, score %.4f vs %.4f\n", i, length, shortest, graph.difficulty(), evaluateDifficulty(grid));
+        }
+    }
+
+    long long cells = static_cast<long long>(opt.rows) * opt.cols;
+    printf("mazegen bench-solve: %d %s mazes of %dx%d, seed %s, avg path %.1f cells\n", opt.count,
+           opt.algorithm == ALGO_ELLER ? "eller" : "dfs", opt.cols, opt.rows, formatSeed(opt.seed).c_str(), static_cast<double>(pathSum) / opt.count);
+    printf("  %-8s %14s %10s %12s %10s %10s %8s\n", "solver", "expanded/maze", "% of cells", "ms/maze", "ns/cell", "peak MB", "wrong");
+    int wrong = 0;
+    for (int k = 0; k < SOLVER_KIND_COUNT; ++k)
+    {
+        printf("  %-8s %14.1f %9.1f%% %12.4f %10.2f %10.1f %8d\n", solvers[k]->name(), static_cast<double>(expanded[k]) / opt.count,
+               100.0 * expanded[k] / (static_cast<double>(cells) * opt.count), ms[k] / opt.count, ms[k] * 1e6 / (static_cast<double>(cells) * opt.count),
+               solvers[k]->memoryBytes() / 1048576.0, bad[k]);
+        wrong += bad[k];
+    }
+    printf("  %-8s %14lld %9.1f%% %12.4f %10.2f %10s %8d   (built once, then O(1) per cell)\n", "field", cells, 100.0, fieldMs / opt.count,
+           fieldMs * 1e6 / (static_cast<double>(cells) * opt.count), "", fieldBad);
+    printf("  %-8s %14.1f %9.1f%% %12.4f %10.2f %10s %8d   (junction again on the same maze, graph kept)\n", "repeat",
+           static_cast<double>(repeatExpanded) / opt.count, 100.0 * repeatExpanded / (static_cast<double>(cells) * opt.count), repeatMs / opt.count,
+           repeatMs * 1e6 / (static_cast<double>(cells) * opt.count), "", repeatBad);
+    printf("junction graph: %.1f nodes (%.1f%% of cells), %.1f edges per maze, %d wrong\n", static_cast<double>(graphNodes) / opt.count,
+           100.0 * graphNodes / (static_cast<double>(cells) * opt.count), static_cast<double>(graphEdges) / opt.count, graphBad);
+    printf("  build %.4f ms, route %.4f ms (%.1f nodes expanded), expand to cells %.4f ms per maze\n", graphMs[0] / opt.count,
+           graphMs[1] / opt.count, static_cast<double>(routeExpanded) / opt.count, graphMs[2] / opt.count);
+    return wrong + fieldBad + graphBad + repeatBad ? 1 : 0;
+}
+
+// ---------- bench-parallel: multi-threaded BFS scaling ---------- //
+static int runBenchParallel(const CliOptions &opt)
+{
+    int maxThreads = opt.threads > 0 ? opt.threads : 32;
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2)
+        threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    // mazes this large are slow to build, so each one is generated once and
+    // solved by every configuration before the next is built
+    BfsSolver bfs;
+    vector<double> ms(threadCounts.size(), 0.0);
+    double bfsMs = 0;
+    long long expanded = 0, parallelLevels = 0;
+    int wrong = 0;
+    MazeGrid grid;
+    vector<Coord> path;
+    for (int i = 0; i < opt.count; ++i)
+    {
+        generateMaze(grid, opt.rows, opt.cols, deriveSeed(opt.seed, static_cast<unsigned long long>(i)), opt.algorithm);
+        SolveStats stats;
+        bfs.solve(grid, path, &stats);
+        bfsMs += stats.ms;
+        expanded += stats.expanded;
+        size_t shortest = path.size();
+        for (size_t k = 0; k < threadCounts.size(); ++k)
+        {
+            ParallelBfsSolver solver(threadCounts[k]);
+            solver.solve(grid, path, &stats);
+            ms[k] += stats.ms;
+            if (k + 1 == threadCounts.size())
+                parallelLevels += solver.lastWideLevels();
+            if (path.size() != shortest)
+            {
+                wrong++;
+                fprintf(stderr, "maze %d: %d threads returned %zu cells, bfs %zu\n", i, threadCounts[k], path.size(), shortest);
+            }
+        }
+    }
+
+    printf("mazegen bench-parallel: %d %s mazes of %dx%d, seed %s, %u hardware threads\n", opt.count,
+           opt.algorithm == ALGO_ELLER ? "eller" : "dfs", opt.cols, opt.rows, formatSeed(opt.seed).c_str(), thread::hardware_concurrency());
+    printf("  %.0f cells expanded per maze; %.1f levels per maze reach %d cells and are split across workers\n",
+           static_cast<double>(expanded) / opt.count, static_cast<double>(parallelLevels) / opt.count, 2 * ParallelBfsSolver::CELLS_PER_SLICE);
+    printf("  %-8s %12s %10s %10s\n", "threads", "ms/maze", "speedup", "vs bfs");
+    printf("  %-8s %12.1f %10s %9.2fx\n", "bfs", bfsMs / opt.count, "-", 1.0);
+    for (size_t k = 0; k < threadCounts.size(); ++k)
+        printf("  %-8d %12.1f %9.2fx %9.2fx\n", threadCounts[k], ms[k] / opt.count, ms[0] / ms[k], bfsMs / ms[k]);
+    return wrong ? 1 : 0;
+}
+
+// ---------- bench-dynamic: D* Lite under shifting walls ---------- //
+static int runBenchDynamic(const CliOptions &opt)
+{
+    const float dt = 1.0f / 60.0f;
+    const int framesPerStep = 4; // the walker takes 15 steps a second
+    MazeGrid grid;
+    generateMaze(grid, opt.rows, opt.cols, opt.seed, opt.algorithm);
+    int walls = opt.walls > 0 ? opt.walls : max(8, grid.size() / 400);
+    ShiftingWalls traps;
+    traps.place(grid, deriveSeed(opt.seed, 1), walls);
+    int goal = grid.size() - 1;
+
+    DStarLite dstar;
+    Clock::time_point t0 = Clock::now();
+    dstar.reset(grid, 0, goal);
+    double initialMs = msSince(t0);
+    long long initialExpanded = dstar.expanded();
+
+    BfsSolver bfs;
+    vector<int> toggled;
+    vector<Coord> path, check;
+    int frames = opt.count * 60, player = 0, wrong = 0, cutOff = 0, arrivals = 0;
+    long long toggles = 0, expanded = 0, bfsExpanded = 0;
+    double totalMs = 0, bfsMs = 0;
+    vector<double> frameMs;
+    frameMs.reserve(frames);
+    for (int f = 0; f < frames; ++f)
+    {
+        t0 = Clock::now();
+        toggled.clear();
+        traps.update(grid, dt, toggled);
+        for (int i : toggled)
+        {
+            dstar.wallChanged(traps[i].wallCell, traps[i].wallSide);
+            dstar.wallChanged(traps[i].gapCell, traps[i].gapSide);
+        }
+        if (f % framesPerStep == 0)
+        {
+            int d = dstar.nextMove();
+            if (d >= 0)
+                player += DIR_DY[d] * grid.getCols() + DIR_DX[d];
+            if (player == goal)
+            {
+                player = 0;
+                arrivals++;
+            }
+            dstar.moveStart(player);
+        }
+        dstar.update();
+        dstar.path(path);
+        double ms = msSince(t0);
+        totalMs += ms;
+        frameMs.push_back(ms);
+        toggles += static_cast<long long>(toggled.size());
+        expanded += dstar.expandedLastUpdate();
+
+        // what re-solving from scratch every frame would cost, and the check
+        SolveStats stats;
+        bfs.solve(grid, player, goal, check, &stats);
+        bfsMs += stats.ms;
+        bfsExpanded += stats.expanded;
+        if (check.empty())
+            cutOff++;
+        if (check.size() != path.size() || dstar.distance() != static_cast<int>(check.size()) - 1)
+        {
+            wrong++;
+            if (wrong <= 5)
+                fprintf(stderr, "frame %d: d* lite %zu cells, bfs %zu\n", f, path.size(), check.size());
+        }
+    }
+
+    sort(frameMs.begin(), frameMs.end());
+    double medianMs = frames ? frameMs[frames / 2] : 0, p99Ms = frames ? frameMs[frames * 99 / 100] : 0, worstMs = frames ? frameMs.back() : 0;
+    printf("mazegen bench-dynamic: %dx%d %s maze, seed %s, %d shifting walls, %d frames at 60 FPS\n", opt.cols, opt.rows,
+           opt.algorithm == ALGO_ELLER ? "eller" : "dfs", formatSeed(opt.seed).c_str(), traps.size(), frames);
+    printf("  %.1f wall moves per second, goal reached %d times, walled off in %d frames\n", toggles / (frames * dt), arrivals, cutOff);
+    printf("  initial solve  %10.3f ms %12lld cells\n", initialMs, initialExpanded);
+    printf("  d* lite/frame  %10.4f ms %12.1f cells   (median %.3f, p99 %.3f, worst %.3f ms of the 16.7 ms budget)\n",
+           totalMs / frames, static_cast<double>(expanded) / frames, medianMs, p99Ms, worstMs);
+    printf("  bfs/frame      %10.4f ms %12.1f cells\n", bfsMs / frames, static_cast<double>(bfsExpanded) / frames);
+    printf("  %d frames with a wrong path\n", wrong);
+    return wrong ? 1 : 0;
+}
+
+// ---------- bench-mesh: merged wall runs ---------- //
+static int runBenchMesh(const CliOptions &opt)
+{
+    MazeGrid grid;
+    WallMesh mesh;
+    WallStyle style;
+    // every unit edge the runs cover, counted so duplicates show up
+    vector<int> horizontal, vertical;
+    long long cellWalls = 0, edges = 0, runs = 0, quads = 0, batches = 0;
+    int bad = 0;
+    double buildMs = 0, layoutMs = 0;
+    for (int i = 0; i < opt.count; ++i)
+    {
+        generateMaze(grid, opt.rows, opt.cols, deriveSeed(opt.seed, static_cast<unsigned long long>(i)), opt.algorithm);
+        Clock::time_point t0 = Clock::now();
+        mesh.build(grid);
+        buildMs += msSince(t0);
+        t0 = Clock::now();
+        mesh.layout(0, 0, 16, 3, style);
+        layoutMs += msSince(t0);
+
+        horizontal.assign(static_cast<size_t>(opt.rows + 1) * opt.cols, 0);
+        vertical.assign(static_cast<size_t>(opt.cols + 1) * opt.rows, 0);
+        for (const WallRun &r : mesh.runs())
+            for (int k = r.from; k < r.to; ++k)
+                (r.horizontal ? horizontal[r.line * opt.cols + k] : vertical[r.line * opt.rows + k])++;
+        int mismatches = 0;
+        for (int y = 0; y < opt.rows; ++y)
+            for (int x = 0; x < opt.cols; ++x)
+            {
+                cellWalls += 4 - grid.openSides(grid.index(x, y));
+                mismatches += horizontal[y * opt.cols + x] != static_cast<int>(grid.hasWall(x, y, DIR_UP));
+                mismatches += horizontal[(y + 1) * opt.cols + x] != static_cast<int>(grid.hasWall(x, y, DIR_DOWN));
+                mismatches += vertical[x * opt.rows + y] != static_cast<int>(grid.hasWall(x, y, DIR_LEFT));
+                mismatches += vertical[(x + 1) * opt.rows + y] != static_cast<int>(grid.hasWall(x, y, DIR_RIGHT));
+            }
+        if (mismatches)
+        {
+            bad++;
+            fprintf(stderr, "maze %d: %d wall edges missing or doubled\n", i, mismatches);
+        }
+        edges += mesh.edgeCount();
+        runs += mesh.runs().size();
+        quads += mesh.quadCount();
+        batches += (mesh.vertices().size() + 4095) / 4096; // the game's chunk size
+    }
+
+    // a per-cell DrawGreenWall is two filled rectangles (4 vertices each)
+    // and an outline of four lines (8 vertices)
+    double n = opt.count;
+    printf("mazegen bench-mesh: %d %s mazes of %dx%d, seed %s\n", opt.count,
+           opt.algorithm == ALGO_ELLER ? "eller" : "dfs", opt.cols, opt.rows, formatSeed(opt.seed).c_str());
+    printf("  per cell  %10.0f walls drawn, %.0f draw calls, %.0f vertices\n", cellWalls / n, cellWalls * 3 / n, cellWalls * 16 / n);
+    printf("  merged    %10.0f edges, %.0f runs, %.0f quads in %.0f batches, %.0f vertices (%.1fx fewer)\n",
+           edges / n, runs / n, quads / n, batches / n, quads * 4 / n, static_cast<double>(cellWalls * 16) / (quads * 4));
+    printf("  build     %10.3f ms/maze\n", buildMs / n);
+    printf("  layout    %10.3f ms/maze\n", layoutMs / n);
+    printf("  %d mazes with wrong runs\n", bad);
+    return bad ? 1 : 0;
+}
+
+// ---------- stream: Eller's rows straight to a file ---------- //
+static int runStream(const CliOptions &opt)
+{
+    FILE *out = nullptr;
+    if (!opt.outPath.empty())
+    {
+        out = fopen(opt.outPath.c_str(), "wb");
+        if (!out)
+        {
+            fprintf(stderr, "mazegen: cannot open '%s'\n", opt.outPath.c_str());
+            return 1;
+        }
+        int header[2] = {opt.rows, opt.cols};
+        fwrite("MZR1", 1, 4, out);
+        fwrite(header, sizeof(int), 2, out);
+    }
+
+    // rows arrive complete (north and south walls known), so shape counts are
+    // taken on the fly without ever holding the maze
+    MazeMetrics shape;
+    bool writeFailed = false;
+    Clock::time_point t0 = Clock::now();
+    generateEllerRows(opt.rows, opt.cols, opt.seed, [&](int, const unsigned char *row, int cols)
+                      {
+        if (out && fwrite(row, 1, cols, out) != static_cast<size_t>(cols))
+            writeFailed = true; }, &shape);
+    double ms = msSince(t0);
+    if (out)
+        writeFailed |= fclose(out) != 0;
+    if (writeFailed)
+    {
+        fprintf(stderr, "mazegen: failed writing '%s'\n", opt.outPath.c_str());
+        return 1;
+    }
+
+    long long cells = static_cast<long long>(opt.rows) * opt.cols;
+    printf("mazegen stream: %dx%d eller maze, seed %s%s%s\n", opt.cols, opt.rows, formatSeed(opt.seed).c_str(),
+           out ? " -> " : "", opt.outPath.c_str());
+    printf("  total     %10.2f ms  (%.0f rows/s, %.1f ns/cell)\n", ms, opt.rows / (ms / 1000.0), ms * 1e6 / cells);
+    printf("  dead ends %d, branches %d, score %.2f\n", shape.deadEnds, shape.branches, difficultyScore(opt.rows, opt.cols, shape));
+    return 0;
+}
+
+// ---------- endless: chunk cache soak test ---------- //
+static int runEndless(const CliOptions &opt)
+{
+    const int radius = 24;
+    ChunkedMaze world;
+    world.reset(opt.seed);
+
+    // remember the walls around the origin, then travel far away and back
+    vector<unsigned char> before;
+    for (int y = -radius; y <= radius; ++y)
+        for (int x = -radius; x <= radius; ++x)
+            before.push_back(world.wallMask(x, y));
+
+    int mismatches = 0, maxResident = 0;
+    Clock::time_point t0 = Clock::now();
+    for (int step = 0; step < opt.count; ++step)
+    {
+        int px = step * 5, py = -step * 3;
+        world.ensureWindow(px, py, radius);
+        maxResident = max(maxResident, world.residentChunks());
+        // both sides of a shared edge must agree
+        for (int k = -radius; k <= radius; k += 7)
+        {
+            mismatches += world.hasWall(px + k, py, DIR_RIGHT) != world.hasWall(px + k + 1, py, DIR_LEFT);
+            mismatches += world.hasWall(px, py + k, DIR_DOWN) != world.hasWall(px, py + k + 1, DIR_UP);
+        }
+    }
+    double ms = msSince(t0);
+
+    int changed = 0;
+    size_t n = 0;
+    for (int y = -radius; y <= radius; ++y)
+        for (int x = -radius; x <= radius; ++x)
+            changed += world.wallMask(x, y) != before[n++];
+
+    printf("mazegen endless: %d window moves, chunk %dx%d, seed %s\n", opt.count, world.getChunkSize(), world.getChunkSize(), formatSeed(opt.seed).c_str());
+    printf("  chunks generated %lld, evicted %lld, max resident %d (cap %d)\n",
+           world.chunksGenerated(), world.chunksEvicted(), maxResident, world.maxChunks());
+    printf("  border mismatches %d, changed cells after revisit %d\n", mismatches, changed);
+    printf("  total     %10.2f ms\n", ms);
+    return mismatches || changed ? 1 : 0;
+}
+
+// ---------- alloc: heap traffic per maze after warm-up ---------- //
+struct AllocCounter
+{
+    long long heap = 0, slabs = 0;
+    long long heap0 = 0, slabs0 = 0;
+    void begin()
+    {
+        heap0 = heapAllocations.load();
+        slabs0 = poolSlabAllocations.load();
+    }
+    void end()
+    {
+        heap += heapAllocations.load() - heap0;
+        slabs += poolSlabAllocations.load() - slabs0;
+    }
+};
+
+static int runAlloc(const CliOptions &opt)
+{
+    MazeGrid grid;
+    LinkedList moves;
+    AllocCounter gen, solve, score, path;
+    long long moveCount = 0;
+
+    // the first --warmup rounds fill the pools and scratch buffers and are
+    // not counted; after that the pools only grow when a maze needs a deeper
+    // stack or longer path than any before it (one slab per 1024 nodes)
+    for (int i = 0; i < opt.warmup + opt.count; ++i)
+    {
+        bool counted = i >= opt.warmup;
+        if (counted)
+            gen.begin();
+        generateMaze(grid, opt.rows, opt.cols, deriveSeed(opt.seed, static_cast<unsigned long long>(i)), opt.algorithm);
+        if (counted)
+            gen.end();
+
+        if (counted)
+            solve.begin();
+        vector<Coord> sol = BFSSolve(grid);
+        if (counted)
+            solve.end();
+
+        if (counted)
+            score.begin();
+        evaluateDifficulty(grid);
+        if (counted)
+            score.end();
+
+        // a player that walks the solution, stepping back once per move
+        if (counted)
+            path.begin();
+        moves.clear();
+        for (size_t k = 0; k < sol.size(); ++k)
+        {
+            moves.add(PlayerMove(sol[k].x, sol[k].y, 0.0f));
+            if (k > 0)
+            {
+                moves.add(PlayerMove(sol[k - 1].x, sol[k - 1].y, 0.0f));
+                moves.add(PlayerMove(sol[k].x, sol[k].y, 0.0f));
+            }
+        }
+        if (counted)
+        {
+            path.end();
+            moveCount += moves.getSize();
+        }
+    }
+
+    long long cells = static_cast<long long>(opt.rows) * opt.cols;
+    printf("mazegen alloc: %d mazes of %dx%d after %d warm-up, seed %s\n", opt.count, opt.cols, opt.rows, opt.warmup, formatSeed(opt.seed).c_str());
+    printf("  %-10s %14s %14s %16s\n", "phase", "heap/maze", "slabs/maze", "heap/1k cells");
+    const char *names[4] = {"generate", "solve", "score", "playerPath"};
+    AllocCounter *counters[4] = {&gen, &solve, &score, &path};
+    for (int k = 0; k < 4; ++k)
+        printf("  %-10s %14.2f %14.2f %16.4f\n", names[k], static_cast<double>(counters[k]->heap) / opt.count,
+               static_cast<double>(counters[k]->slabs) / opt.count, counters[k]->heap * 1000.0 / (cells * opt.count));
+    printf("  (%lld player moves recorded)\n", moveCount);
+    return 0;
+}
+
+// ---------- show: rebuild one maze from its seed ---------- //
+static int runShow(const CliOptions &opt)
+{
+    if (!opt.seedGiven)
+    {
+        fprintf(stderr, "mazegen show: --seed is required\n");
+        return 1;
+    }
+    MazeGrid grid;
+    const char *kind = opt.algorithm == ALGO_ELLER ? "eller" : "dfs";
+    if (opt.difficultyGiven)
+    {
+        float lo, hi;
+        difficultyBand(opt.difficulty, lo, hi);
+        generateForDifficulty(grid, opt.rows, opt.cols, opt.seed, lo, hi);
+        const char *names[3] = {"easy", "medium", "hard"};
+        kind = names[opt.difficulty];
+    }
+    else
+        generateMaze(grid, opt.rows, opt.cols, opt.seed, opt.algorithm);
+    vector<Coord> path = BFSSolve(grid);
+
+    printf("mazegen show: %dx%d %s maze, seed %s\n", opt.cols, opt.rows, kind, formatSeed(opt.seed).c_str());
+    printf("  score %.2f, path %zu cells, digest %s\n", evaluateDifficulty(grid), path.size(), formatSeed(mazeDigest(grid)).c_str());
+    if (!opt.verbose)
+        return 0;
+    // ASCII picture: "+--+" tops, "|  " sides
+    string line;
+    for (int y = 0; y < opt.rows; ++y)
+    {
+        line.clear();
+        for (int x = 0; x < opt.cols; ++x)
+            line += grid.hasWall(x, y, DIR_UP) ? "+--" : "+  ";
+        printf("%s+\n", line.c_str());
+        line.clear();
+        for (int x = 0; x < opt.cols; ++x)
+            line += grid.hasWall(x, y, DIR_LEFT) ? "|  " : "   ";
+        printf("%s%c\n", line.c_str(), grid.hasWall(opt.cols - 1, y, DIR_RIGHT) ? '|' : ' ');
+    }
+    line.clear();
+    for (int x = 0; x < opt.cols; ++x)
+        line += grid.hasWall(x, opt.rows - 1, DIR_DOWN) ? "+--" : "+  ";
+    printf("%s+\n", line.c_str());
+    return 0;
+}
+
+static int runCommand(const CliOptions &opt)
+{
+    if (opt.command == "batch")
+        return runBatch(opt);
+    if (opt.command == "pick")
+        return runPick(opt);
+    if (opt.command == "target")
+        return runTarget(opt);
+    if (opt.command == "bench-gen")
+        return runBenchGen(opt);
+    if (opt.command == "bench-score")
+        return runBenchScore(opt);
+    if (opt.command == "bench-solve")
+        return runBenchSolve(opt);
+    if (opt.command == "bench-parallel")
+        return runBenchParallel(opt);
+    if (opt.command == "bench-dynamic")
+        return runBenchDynamic(opt);
+    if (opt.command == "bench-mesh")
+        return runBenchMesh(opt);
+    if (opt.command == "stream")
+        return runStream(opt);
+    if (opt.command == "endless")
+        return runEndless(opt);
+    if (opt.command == "alloc")
+        return runAlloc(opt);
+    if (opt.command == "show")
+        return runShow(opt);
+    fprintf(stderr, "mazegen: unknown command '%s'\n", opt.command.c_str());
+    printUsage();
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    CliOptions opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        printUsage();
+        return 1;
+    }
+    if (!opt.tracePath.empty())
+    {
+        if (!traceStart(opt.tracePath))
+        {
+            fprintf(stderr, "mazegen: cannot write %s\n", opt.tracePath.c_str());
+            return 1;
+        }
+        traceThreadName("main");
+    }
+    int result = runCommand(opt);
+    traceStop();
+    return result;
+}
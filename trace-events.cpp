@@ -0,0 +1,245 @@
+#include "trace-events.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+atomic<bool> traceActive(false);
+atomic<unsigned> traceSession(0);
+
+namespace
+{
+struct TraceEvent
+{
+    const char *name, *detail;
+    long long ts, dur; // ns
+    int id;
+    unsigned session; // trace the timestamps belong to
+    char phase;       // 'X' complete, 'B' begin, 'E' end
+};
+
+// Only the owning thread writes a chunk: it fills events[used] and then
+// publishes it by storing used + 1. The flusher reads up to used and frees a
+// chunk once it is full and the owner has moved on to next.
+const int CHUNK_EVENTS = 4096;
+struct TraceChunk
+{
+    TraceEvent events[CHUNK_EVENTS];
+    atomic<int> used{0};
+    atomic<TraceChunk *> next{nullptr};
+};
+
+struct ThreadBuffer
+{
+    int tid = 0;
+    string name; // guarded by registryLock
+    TraceChunk *head = nullptr, *tail = nullptr; // flusher's end, owner's end
+    int flushed = 0; // events of head already written
+};
+
+mutex registryLock;
+vector<unique_ptr<ThreadBuffer>> buffers; // kept for the life of the process
+thread_local ThreadBuffer *localBuffer = nullptr;
+
+mutex fileLock; // the file, firstEvent and the flush cursors
+FILE *out = nullptr;
+bool firstEvent = true;
+atomic<long long> epochNs(0); // steady_clock time of traceStart(), read by every thread
+
+long long steadyNs()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+mutex flusherLock;
+condition_variable flusherWake;
+bool flusherStopping = false;
+thread flusher;
+
+ThreadBuffer &local()
+{
+    if (!localBuffer)
+    {
+        lock_guard<mutex> g(registryLock);
+        buffers.emplace_back(new ThreadBuffer());
+        localBuffer = buffers.back().get();
+        localBuffer->tid = static_cast<int>(buffers.size());
+        localBuffer->head = localBuffer->tail = new TraceChunk();
+    }
+    return *localBuffer;
+}
+
+void record(const TraceEvent &e)
+{
+    ThreadBuffer &b = local();
+    TraceChunk *c = b.tail;
+    int n = c->used.load(memory_order_relaxed);
+    if (n == CHUNK_EVENTS)
+    {
+        TraceChunk *fresh = new TraceChunk();
+        c->next.store(fresh, memory_order_release);
+        b.tail = c = fresh;
+        n = 0;
+    }
+    c->events[n] = e;
+    c->used.store(n + 1, memory_order_release);
+}
+
+void writeEvent(const TraceEvent &e, int tid)
+{
+    fprintf(out, "%s\n{\"name\":\"%s\",\"cat\":\"maze\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+            firstEvent ? "" : ",", e.name, e.phase, e.ts / 1000.0, tid);
+    firstEvent = false;
+    if (e.phase == 'X')
+        fprintf(out, ",\"dur\":%.3f", e.dur / 1000.0);
+    if (e.detail || e.id >= 0)
+    {
+        fprintf(out, ",\"args\":{");
+        if (e.detail)
+            fprintf(out, "\"detail\":\"%s\"%s", e.detail, e.id >= 0 ? "," : "");
+        if (e.id >= 0)
+            fprintf(out, "\"id\":%d", e.id);
+        fprintf(out, "}");
+    }
+    fprintf(out, "}");
+}
+
+// Moves every buffer's cursor past the events published so far, writing
+// those of the current trace when write is set (and a file is open). Call
+// with fileLock held.
+void drainBuffers(bool write)
+{
+    vector<ThreadBuffer *> all;
+    {
+        lock_guard<mutex> g(registryLock);
+        for (auto &b : buffers)
+            all.push_back(b.get());
+    }
+    unsigned session = traceSession.load(memory_order_relaxed);
+    for (ThreadBuffer *b : all)
+    {
+        for (;;)
+        {
+            TraceChunk *c = b->head;
+            int used = c->used.load(memory_order_acquire);
+            for (int i = b->flushed; write && i < used; ++i)
+                if (c->events[i].session == session)
+                    writeEvent(c->events[i], b->tid);
+            b->flushed = used;
+            TraceChunk *next = c->next.load(memory_order_acquire);
+            if (used < CHUNK_EVENTS || !next)
+                break;
+            delete c;
+            b->head = next;
+            b->flushed = 0;
+        }
+    }
+}
+
+void flushBuffers()
+{
+    lock_guard<mutex> g(fileLock);
+    if (!out)
+        return;
+    drainBuffers(true);
+    fflush(out);
+}
+
+void flusherLoop()
+{
+    unique_lock<mutex> g(flusherLock);
+    while (!flusherStopping)
+    {
+        flusherWake.wait_for(g, chrono::milliseconds(250));
+        g.unlock();
+        flushBuffers();
+        g.lock();
+    }
+}
+} // namespace
+
+// ---------- Control ---------- //
+bool traceStart(const string &path)
+{
+    traceStop();
+    {
+        lock_guard<mutex> g(fileLock);
+        out = fopen(path.c_str(), "w");
+        if (!out)
+            return false;
+        fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        firstEvent = true;
+        // Leftovers of an earlier trace are dropped here; a span that was
+        // still open across the restart carries the old session and is
+        // skipped when written, so no old timestamps reach the new file.
+        traceSession.fetch_add(1, memory_order_relaxed);
+        drainBuffers(false);
+        epochNs.store(steadyNs(), memory_order_relaxed);
+    }
+    flusherStopping = false;
+    flusher = thread(flusherLoop);
+    traceActive.store(true, memory_order_release);
+    return true;
+}
+
+void traceStop()
+{
+    if (!traceActive.exchange(false, memory_order_acq_rel))
+        return;
+    {
+        lock_guard<mutex> g(flusherLock);
+        flusherStopping = true;
+    }
+    flusherWake.notify_all();
+    flusher.join();
+    flushBuffers();
+
+    lock_guard<mutex> g(fileLock);
+    {
+        lock_guard<mutex> r(registryLock);
+        for (auto &b : buffers)
+            if (!b->name.empty())
+            {
+                fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                        firstEvent ? "" : ",", b->tid, b->name.c_str());
+                firstEvent = false;
+            }
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+    out = nullptr;
+}
+
+// ---------- Recording ---------- //
+long long traceNow()
+{
+    return steadyNs() - epochNs.load(memory_order_relaxed);
+}
+
+void traceComplete(unsigned session, const char *name, long long startNs, long long endNs, const char *detail, int id)
+{
+    // a span that outlived traceStop() is dropped
+    if (traceEnabled())
+        record({name, detail, startNs, endNs - startNs, id, session, 'X'});
+}
+
+void traceBegin(const char *name)
+{
+    record({name, nullptr, traceNow(), 0, -1, traceSession.load(memory_order_acquire), 'B'});
+}
+
+void traceEnd()
+{
+    record({"", nullptr, traceNow(), 0, -1, traceSession.load(memory_order_acquire), 'E'});
+}
+
+void traceThreadName(const string &name)
+{
+    ThreadBuffer &b = local();
+    lock_guard<mutex> g(registryLock);
+    b.name = name;
+}
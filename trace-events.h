@@ -0,0 +1,79 @@
+// Chrome trace_event export: spans recorded while tracing is on are written
+// as JSON that chrome://tracing and Perfetto open directly. Each thread
+// appends to its own chunked buffer with no locks; a background thread
+// writes finished events to the file every few hundred milliseconds, so
+// the traced code never waits on I/O.
+//
+// While tracing is off a span costs one relaxed atomic load. Building with
+// MAZE_NO_TRACE turns every MAZE_TRACE_* macro into nothing.
+#pragma once
+
+#include <atomic>
+#include <string>
+
+extern std::atomic<bool> traceActive;
+extern std::atomic<unsigned> traceSession; // bumped by every traceStart()
+
+// starts a trace written to path; false if the file cannot be created
+bool traceStart(const std::string &path);
+// writes everything still buffered, closes the JSON and the file
+void traceStop();
+// acquire pairs with traceStart()'s release, so a thread that sees tracing
+// on also sees the new trace's epoch and session
+inline bool traceEnabled() { return traceActive.load(std::memory_order_acquire); }
+
+// nanoseconds since traceStart()
+long long traceNow();
+// Names and details must outlive the trace (string literals in practice);
+// only the pointers are stored. id < 0 means none. session is the
+// traceSession value when the span began; a span begun under an earlier
+// trace is never written to a later one.
+void traceComplete(unsigned session, const char *name, long long startNs, long long endNs, const char *detail = nullptr, int id = -1);
+// open and close a span on this thread, for code that does not fit a scope
+void traceBegin(const char *name);
+void traceEnd();
+// labels the calling thread in the viewer; ignored while tracing is off
+void traceThreadName(const std::string &name);
+
+class TraceScope
+{
+    const char *name, *detail;
+    int id;
+    unsigned session;
+    long long start;
+    bool active;
+
+public:
+    explicit TraceScope(const char *n, const char *d = nullptr, int i = -1)
+        : name(n), detail(d), id(i), session(0), start(0), active(traceEnabled())
+    {
+        if (active)
+        {
+            session = traceSession.load(std::memory_order_acquire);
+            start = traceNow();
+        }
+    }
+    ~TraceScope()
+    {
+        if (active)
+            traceComplete(session, name, start, traceNow(), detail, id);
+    }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+};
+
+#define MAZE_TRACE_CONCAT2(a, b) a##b
+#define MAZE_TRACE_CONCAT(a, b) MAZE_TRACE_CONCAT2(a, b)
+#ifndef MAZE_NO_TRACE
+#define MAZE_TRACE_SCOPE(name) TraceScope MAZE_TRACE_CONCAT(traceScope, __LINE__)(name)
+#define MAZE_TRACE_SCOPE_DETAIL(name, detail, id) TraceScope MAZE_TRACE_CONCAT(traceScope, __LINE__)(name, detail, id)
+#define MAZE_TRACE_BEGIN(name) (traceEnabled() ? traceBegin(name) : (void)0)
+#define MAZE_TRACE_END() (traceEnabled() ? traceEnd() : (void)0)
+#define MAZE_TRACE_THREAD_NAME(name) (traceEnabled() ? traceThreadName(name) : (void)0)
+#else
+#define MAZE_TRACE_SCOPE(name) ((void)0)
+#define MAZE_TRACE_SCOPE_DETAIL(name, detail, id) ((void)0)
+#define MAZE_TRACE_BEGIN(name) ((void)0)
+#define MAZE_TRACE_END() ((void)0)
+#define MAZE_TRACE_THREAD_NAME(name) ((void)0)
+#endif
@@ -0,0 +1,119 @@
+#include "wall-mesh.h"
+#include <algorithm>
+using namespace std;
+
+// ---------- Runs ---------- //
+void WallMesh::build(const MazeGrid &grid, int x0, int y0, int x1, int y1)
+{
+    int rows = grid.getRows();
+    int cols = grid.getCols();
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, cols);
+    y1 = min(y1, rows);
+    wallRuns.clear();
+    edges = 0;
+
+    // horizontal line y is the top of row y; the last one is the bottom of
+    // the last row
+    for (int line = y0; line <= y1 && y0 < y1; ++line)
+    {
+        int y = line < rows ? line : rows - 1;
+        int side = line < rows ? DIR_UP : DIR_DOWN;
+        for (int x = x0; x < x1;)
+        {
+            if (!grid.hasWall(x, y, side))
+            {
+                ++x;
+                continue;
+            }
+            WallRun run;
+            run.horizontal = true;
+            run.line = line;
+            run.from = x;
+            while (x < x1 && grid.hasWall(x, y, side))
+                ++x;
+            run.to = x;
+            edges += run.to - run.from;
+            wallRuns.push_back(run);
+        }
+    }
+
+    // vertical line x is the left of column x; the last one is the right of
+    // the last column
+    for (int line = x0; line <= x1 && x0 < x1; ++line)
+    {
+        int x = line < cols ? line : cols - 1;
+        int side = line < cols ? DIR_LEFT : DIR_RIGHT;
+        for (int y = y0; y < y1;)
+        {
+            if (!grid.hasWall(x, y, side))
+            {
+                ++y;
+                continue;
+            }
+            WallRun run;
+            run.horizontal = false;
+            run.line = line;
+            run.from = y;
+            while (y < y1 && grid.hasWall(x, y, side))
+                ++y;
+            run.to = y;
+            edges += run.to - run.from;
+            wallRuns.push_back(run);
+        }
+    }
+}
+
+// ---------- Vertex buffer ---------- //
+void WallMesh::quad(float x0, float y0, float x1, float y1, WallColor c)
+{
+    // same corner order as raylib's own rectangles
+    verts.push_back({x0, y0, c});
+    verts.push_back({x0, y1, c});
+    verts.push_back({x1, y1, c});
+    verts.push_back({x1, y0, c});
+}
+
+void WallMesh::layout(float originX, float originY, float cellSize, float thickness, const WallStyle &style)
+{
+    verts.clear();
+    verts.reserve(wallRuns.size() * 12);
+    float half = thickness / 2.0f;
+    float ow = style.outlineWidth;
+    for (const WallRun &run : wallRuns)
+    {
+        float x0, y0, x1, y1;
+        if (run.horizontal)
+        {
+            x0 = originX + run.from * cellSize;
+            x1 = originX + run.to * cellSize;
+            y0 = originY + run.line * cellSize - half;
+            y1 = y0 + thickness;
+        }
+        else
+        {
+            x0 = originX + run.line * cellSize - half;
+            x1 = x0 + thickness;
+            y0 = originY + run.from * cellSize;
+            y1 = originY + run.to * cellSize;
+        }
+        // the outline is the whole run drawn first; fill and highlight cover
+        // all of it but an ow-wide border, so no separate edge quads are needed
+        if (ow > 0)
+        {
+            quad(x0, y0, x1, y1, style.outline);
+            x0 += ow;
+            y0 += ow;
+            x1 -= ow;
+            y1 -= ow;
+            if (x1 <= x0 || y1 <= y0)
+                continue;
+        }
+        quad(x0, y0, x1, y1, style.fill);
+        if (run.horizontal)
+            quad(x0, y0, x1, y0 + (y1 - y0) * style.highlightShare, style.highlight);
+        else
+            quad(x0, y0, x0 + (x1 - x0) * style.highlightShare, y1, style.highlight);
+    }
+}
@@ -0,0 +1,62 @@
+// Wall geometry for drawing a whole maze at once. Every wall edge is taken
+// from one side only, so a wall two cells share appears once, and edges
+// that continue along the same grid line are merged into a single run. The
+// runs are then laid out as coloured quads in one vertex buffer that the
+// game hands to the renderer as a single batch.
+#pragma once
+
+#include "maze-core.h"
+#include <vector>
+
+// Unit wall edges from from to to (exclusive) along one grid line. A
+// horizontal run lies on line y = line between x = from and x = to; a
+// vertical one on line x = line between y = from and y = to.
+struct WallRun
+{
+    bool horizontal = true;
+    int line = 0, from = 0, to = 0;
+};
+
+struct WallColor
+{
+    unsigned char r = 0, g = 0, b = 0, a = 255;
+};
+
+// one corner of a quad; every four vertices make a quad, counter-clockwise
+struct WallVertex
+{
+    float x, y;
+    WallColor color;
+};
+
+struct WallStyle
+{
+    WallColor fill, highlight, outline;
+    float highlightShare = 0.45f; // of the fill's thickness, along its top or left edge
+    float outlineWidth = 1.0f;    // 0 draws no outline
+};
+
+class WallMesh
+{
+    std::vector<WallRun> wallRuns;
+    std::vector<WallVertex> verts;
+    int edges = 0;
+
+    void quad(float x0, float y0, float x1, float y1, WallColor c);
+
+public:
+    // collects the merged runs of grid; call it again after every maze change
+    void build(const MazeGrid &grid) { build(grid, 0, 0, grid.getCols(), grid.getRows()); }
+    // Only the walls of cells x0 <= x < x1, y0 <= y < y1, for drawing the
+    // part of a large maze that is on screen. Runs end at the window's edge.
+    void build(const MazeGrid &grid, int x0, int y0, int x1, int y1);
+    // Fills the vertex buffer for the runs at the given screen placement.
+    // Each run is thickness wide, centred on its grid line, and becomes at
+    // most three quads: outline, fill and highlight.
+    void layout(float originX, float originY, float cellSize, float thickness, const WallStyle &style);
+
+    const std::vector<WallRun> &runs() const { return wallRuns; }
+    const std::vector<WallVertex> &vertices() const { return verts; }
+    int edgeCount() const { return edges; } // distinct unit wall edges
+    int quadCount() const { return static_cast<int>(verts.size() / 4); }
+};
@@ -0,0 +1,66 @@
+#include "worker-pool.h"
+#include "trace-events.h"
+using namespace std;
+
+WorkerPool::WorkerPool(int threads)
+{
+    if (threads <= 0)
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    for (int i = 0; i < threads; ++i)
+        workers.emplace_back([this, i]
+                             {
+                                 MAZE_TRACE_THREAD_NAME("worker " + to_string(i));
+                                 run(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        lock_guard<mutex> g(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : workers)
+        t.join();
+}
+
+void WorkerPool::submit(function<void()> task)
+{
+    {
+        lock_guard<mutex> g(lock);
+        tasks.push(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void WorkerPool::waitIdle()
+{
+    unique_lock<mutex> g(lock);
+    idle.wait(g, [this]
+              { return tasks.empty() && busy == 0; });
+}
+
+void WorkerPool::run()
+{
+    for (;;)
+    {
+        function<void()> task;
+        {
+            unique_lock<mutex> g(lock);
+            wake.wait(g, [this]
+                      { return stopping || !tasks.empty(); });
+            if (stopping)
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+            ++busy;
+        }
+        task();
+        {
+            lock_guard<mutex> g(lock);
+            --busy;
+            if (tasks.empty() && busy == 0)
+                idle.notify_all();
+        }
+    }
+}
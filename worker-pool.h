@@ -0,0 +1,35 @@
+// Fixed-size thread pool used for background maze work (candidate
+// generation, later parallel solving). Tasks are plain std::function
+// objects kept in the project's own Queue.
+#pragma once
+
+#include "maze-core.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+    std::vector<std::thread> workers;
+    Queue<std::function<void()>> tasks;
+    std::mutex lock;
+    std::condition_variable wake, idle;
+    int busy = 0;
+    bool stopping = false;
+
+    void run();
+
+public:
+    // threads <= 0 uses one thread per hardware core
+    explicit WorkerPool(int threads = 0);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    int threadCount() const { return static_cast<int>(workers.size()); }
+    void submit(std::function<void()> task);
+    // blocks until the queue is empty and no task is running
+    void waitIdle();
+};